@@ -0,0 +1,144 @@
+/*
+ * AiEngine.cpp
+ *
+ * AiEngine class implementation.
+ * The AiEngine class searches AiPlayer moves asynchronously on a pool of worker threads.
+ * Requests are answered through futures, they can be cancelled and report their progress.
+ */
+
+#include "AiEngine.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+/*
+ * MoveRequest constructor - stores a snapshot of the position, the search works on its own copy of the board.
+ * The stop flag of the limits is ignored, the search watches the flag set by cancel().
+ */
+MoveRequest::MoveRequest(const Board& position, const char mark, const SearchLimits& limits)
+	: position_(position), mark_(mark), limits_(limits), cancelled_(false) {
+	limits_.stop = &cancelled_;
+	result_ = promise_.get_future().share();
+}
+
+/*
+ * cancel() - stops the search as soon as possible. The future is still satisfied, with the best move of the last
+ * completed look ahead (or the first free field if the search has not completed any look ahead yet).
+ */
+void MoveRequest::cancel(){
+	cancelled_.store(true);
+}
+
+/*
+ * isCancelled() - returns true if cancel() has been called
+ */
+bool MoveRequest::isCancelled() const{
+	return cancelled_.load();
+}
+
+/*
+ * getResult() - returns the future of the best move
+ */
+std::shared_future<AiMove> MoveRequest::getResult() const{
+	return result_;
+}
+
+/*
+ * AiEngine constructor - starts the worker threads.
+ * threads is the number of workers, 0 starts one worker per hardware thread. cache (optional) is shared by all workers.
+ */
+AiEngine::AiEngine(const int threads, PositionCache* cache) : shutdown_(false), position_cache_(cache) {
+	int count = threads;
+	if (count <= 0){
+		count = std::thread::hardware_concurrency();
+	}
+	if (count <= 0){
+		count = 1;
+	}
+	for (int i=0; i<count; i++){
+		workers_.push_back(std::thread(&AiEngine::work, this));
+	}
+}
+
+/*
+ * AiEngine destructor - cancels all requests (queued and running), waits for the workers to answer them and stops
+ * the workers.
+ */
+AiEngine::~AiEngine() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		shutdown_ = true;
+		for (int i=0,max=queue_.size(); i<max; i++){
+			queue_[i]->cancel();
+		}
+		for (int i=0,max=running_.size(); i<max; i++){
+			running_[i]->cancel();
+		}
+	}
+	wakeup_.notify_all();
+	for (int i=0,max=workers_.size(); i<max; i++){
+		workers_[i].join();
+	}
+}
+
+/*
+ * requestMove() - queues a search for the best move of the player with mark on the position and returns immediately.
+ * The returned request is used to wait for the result, to cancel the search or to check if it was cancelled.
+ * Throws std::invalid_argument if mark is not X or O. A position where the game is over is answered with the
+ * std::logic_error of AiPlayer::searchMove() through the future.
+ */
+std::shared_ptr<MoveRequest> AiEngine::requestMove(const Board& position, const char mark, const SearchLimits& limits){
+	if (mark != 'X' && mark != 'O'){
+		throw std::invalid_argument(std::string("AI ENGINE - invalid mark '") + mark + "'");
+	}
+	std::shared_ptr<MoveRequest> request = std::make_shared<MoveRequest>(position, mark, limits);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (shutdown_){
+			request->cancel();
+		}
+		queue_.push_back(request);
+	}
+	wakeup_.notify_one();
+	return request;
+}
+
+/*
+ * work() - worker thread. Takes requests from the queue and searches them until the engine shuts down.
+ * Every worker has one AiPlayer per mark, so the search contexts (transposition tables) are reused between requests
+ * without being shared between threads.
+ */
+void AiEngine::work(){
+	AiPlayer player_x('X');
+	AiPlayer player_o('O');
+	player_x.setPositionCache(position_cache_);
+	player_o.setPositionCache(position_cache_);
+
+	while (true){
+		std::shared_ptr<MoveRequest> request;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			while (queue_.empty() && !shutdown_){
+				wakeup_.wait(lock);
+			}
+			if (queue_.empty()){			//shutdown and nothing left to answer
+				return;
+			}
+			request = queue_.front();
+			queue_.pop_front();
+			running_.push_back(request);		//the destructor cancels it while it is searched
+		}
+
+		AiPlayer& player = (request->mark_ == 'X') ? player_x : player_o;
+		try {
+			request->promise_.set_value(player.searchMove(request->position_, request->limits_));
+		} catch (...) {						//pass errors (e.g. full board) to the caller waiting on the future
+			request->promise_.set_exception(std::current_exception());
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		running_.erase(std::find(running_.begin(), running_.end(), request));
+	}
+}
@@ -0,0 +1,69 @@
+/*
+ * AiEngine.h
+ *
+ * AiEngine class definition.
+ * The AiEngine class searches AiPlayer moves asynchronously, so the AI can be embedded in an event loop.
+ * A move is requested with a snapshot of the board and the search limits, the request is answered through a future.
+ * Requests can be cancelled and report their progress (best move after every completed look ahead).
+ * All requests share one pool of worker threads, every worker keeps its own AiPlayers (and search contexts).
+ */
+
+#ifndef AIENGINE_H_
+#define AIENGINE_H_
+
+#include "AiPlayer.h"
+#include "Board.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class MoveRequest {
+public:
+	//Constructor - copies the position. The stop flag of the limits is replaced by the flag of the request, use cancel().
+	MoveRequest(const Board& position, const char mark, const SearchLimits& limits);
+	void cancel();								//Stops the search, the future gets the best move found so far
+	bool isCancelled() const;					//Has the request been cancelled?
+	std::shared_future<AiMove> getResult() const;	//Future of the best move
+private:
+	friend class AiEngine;
+	Board position_;							//snapshot of the board to search
+	char mark_;									//mark of the player to move
+	SearchLimits limits_;						//limits of the search
+	std::atomic<bool> cancelled_;				//stop flag of the search
+	std::promise<AiMove> promise_;				//set by the worker when the search is finished
+	std::shared_future<AiMove> result_;
+};
+
+class AiEngine {
+public:
+	//Constructor - starts the workers (0 = one per hardware thread), the workers share deep search results through the
+	//position cache (optional, not owned)
+	explicit AiEngine(const int threads = 0, PositionCache* cache = NULL);
+	virtual ~AiEngine();						//Destructor - cancels all requests and stops the workers
+
+	//Requests the best move for the player with mark on the position, returns immediately.
+	//The progress callback of the limits is called from a worker thread. Throws std::invalid_argument if mark is not
+	//X or O, the future gets a std::logic_error if the game on the position is over.
+	std::shared_ptr<MoveRequest> requestMove(const Board& position, const char mark, const SearchLimits& limits);
+private:
+	AiEngine(const AiEngine&);					//not copyable
+	AiEngine& operator=(const AiEngine&);
+
+	void work();								//worker thread - answers requests from the queue
+
+	std::vector<std::thread> workers_;
+	std::deque< std::shared_ptr<MoveRequest> > queue_;	//requests waiting for a worker
+	std::vector< std::shared_ptr<MoveRequest> > running_;	//requests being searched by a worker
+	std::mutex mutex_;							//guards queue_, running_ and shutdown_
+	std::condition_variable wakeup_;			//signals new requests or shutdown
+	bool shutdown_;
+	PositionCache* position_cache_;				//shared by all workers or NULL
+};
+
+#endif /* AIENGINE_H_ */
@@ -14,14 +14,21 @@
 
 #include <vector>
 #include <climits>
-#include <sstream>
 #include <ctime>
+#include <algorithm>
+#include <stdexcept>
+
+/*
+ * EngineConfig constructor - the settings of a default AiPlayer
+ */
+EngineConfig::EngineConfig() : look_ahead(AiPlayer::kLookAhead) {
+}
 
 /*
  * AiPlayer constructor, calls the Player constructor.
  * Constructor argument is the mark of the player to be created.
  */
-AiPlayer::AiPlayer(const char mark) : Player(mark) {
+AiPlayer::AiPlayer(const char mark) : Player(mark), look_ahead_(kLookAhead), position_cache_(NULL), profiler_(NULL) {
 }
 
 /*
@@ -34,20 +41,246 @@ AiPlayer::AiPlayer(const char mark) : Player(mark) {
 /*
  * performMove - is responsible for the interaction with the tic-tac-toe board (placing the mark of the Computer on the board).
  * The method performMove expects a pointer to the tic-tac-toe board and a pointer to an instance of the TUI class as inputs.
- * The TUI class is used to display messages of the AiPlayer on the screen.
- * performMove calls the AiPlayer class private function miniMaxAB() in order to generate the best move and uses the method makeMove
- * from the Board class to place the mark on the board.
+ * The AiPlayer does not use the TUI, the move is returned and displayed by the GameSink of the Game.
+ * performMove calls the method searchMove() in order to generate the best move and uses the method makeMove
+ * from the Board class to place the mark on the board. With a profiler set the move is profiled and reported.
+ */
+Move AiPlayer::performMove(Board& board, TUI& /*ui*/){
+	if (profiler_ != NULL){
+		profiler_->beginMove(getMark());
+	}
+	AiMove best_move = searchMove(board, SearchLimits(look_ahead_));
+	if (profiler_ != NULL){
+		profiler_->endMove(best_move.row, best_move.col, context_.statistics().nodes);
+	}
+	board.makeMove(best_move.row, best_move.col, getMark());
+	return Move(best_move.row, best_move.col);
+}
+
+/*
+ * isInteractive() - the AiPlayer generates its moves without user interaction
+ */
+bool AiPlayer::isInteractive() const{
+	return false;
+}
+
+/*
+ * searchMove() - searches the best move for the board, the player with the mark of this AiPlayer is to move.
+ * The search is iteratively deepened up to limits.look_ahead: after every completed look ahead the best move is
+ * reported to limits.progress (if set). When the stop flag of the limits is set or the time limit runs out, the
+ * best move of the last completed look ahead is returned (or the first free field if none has been completed).
+ * The board must not be modified by others while searching, it is left unchanged. Throws std::logic_error if the
+ * game is over (won, dead draw or full board), there is no best move then.
+ */
+AiMove AiPlayer::searchMove(Board& board, const SearchLimits& limits){
+	if (board.evaluateBoard() != Board::PLAY){
+		throw std::logic_error("NO MOVE LEFT - the game is over");
+	}
+	context_.newSearch();
+	context_.beginSearch(limits);
+
+	std::vector<AiMove>& moves = context_.moveBuffer(0);
+	generateMoves(board, moves);
+	AiMove best_move = moves[0];
+	const int max_look_ahead = std::min(limits.look_ahead, static_cast<int>(moves.size()));	// deeper than the game does not help
+
+	for (int look_ahead=1; look_ahead<=max_look_ahead; look_ahead++){
+		AiMove move = miniMaxAB(board, 0, look_ahead, INT_MIN, INT_MAX, getMark());
+		if (context_.stopped()){						// incomplete look ahead - keep the result of the last one
+			break;
+		}
+		best_move = move;
+		if (limits.progress){
+			limits.progress(best_move, look_ahead);
+		}
+	}
+	return best_move;
+}
+
+/*
+ * analyze() - multi-PV search: returns the best lines root moves (all moves if there are fewer) with their exact
+ * scores and principal variations, best first, for the player with the mark of this AiPlayer.
+ * One iteratively deepened search shares the move ordering and the transposition table for all lines, instead of
+ * a search per line with the better moves excluded. Late move reductions are switched off during the analysis,
+ * their null window scores are not exact. A principal variation ends early where the search did not need to
+ * continue (the game ends, the look ahead runs out, or no exact continuation is known).
+ * Stopping works like in searchMove(), the lines of the last completed look ahead are returned (none if no look
+ * ahead has been completed). Throws std::logic_error if the game is over (won, dead draw or full board).
+ */
+std::vector<PvLine> AiPlayer::analyze(Board& board, const SearchLimits& limits, const int lines){
+	if (board.evaluateBoard() != Board::PLAY){
+		throw std::logic_error("NO MOVE LEFT - the game is over");
+	}
+	context_.newSearch();
+	context_.beginSearch(limits);
+
+	std::vector<AiMove>& moves = context_.moveBuffer(0);
+	generateMoves(board, moves);
+	const int max_look_ahead = std::min(limits.look_ahead, static_cast<int>(moves.size()));
+	const SearchOptions options = options_;
+	options_.late_move_reductions = false;
+
+	std::vector<PvLine> best_lines;
+	std::vector<PvLine> result;
+	for (int look_ahead=1; look_ahead<=max_look_ahead; look_ahead++){
+		analyzeRoot(board, look_ahead, std::max(lines, 1), result);
+		if (context_.stopped()){						// incomplete look ahead - keep the lines of the last one
+			break;
+		}
+		best_lines.swap(result);
+		if (limits.progress){
+			limits.progress(best_lines[0].move, look_ahead);
+		}
+	}
+	options_ = options;
+	return best_lines;
+}
+
+/*
+ * analyzeRoot() - the root of the multi-PV search. The root moves are searched in order with the window
+ * (score of the lines-th best move so far, infinity): a move scoring above it is exact and joins the result,
+ * any other move is not among the best lines. The result is sorted best first, equal scores in search order.
+ * The best move is stored in the transposition table to be searched first by the next look ahead.
+ */
+void AiPlayer::analyzeRoot(Board& board, const int look_ahead, const int lines, std::vector<PvLine>& result){
+	SearchStatistics& statistics = context_.statistics();
+	statistics.nodes++;
+	context_.clearPv(0);
+	result.clear();
+
+	const uint64_t key = positionKey(board, getMark());
+	int table_row = 0;
+	int table_col = 0;
+	const TableEntry* entry = context_.probe(key);
+	if (entry != NULL){
+		statistics.table_hits++;
+		table_row = entry->row;
+		table_col = entry->col;
+	}
+	std::vector<AiMove>& moves = context_.moveBuffer(0);
+	generateMoves(board, moves);
+	context_.orderMoves(moves, 0, table_row, table_col);
+
+	for (int i=0,max=moves.size(); i<max; i++){
+		const int threshold = (static_cast<int>(result.size()) < lines) ? INT_MIN : result.back().move.score;
+		board.makeMove(moves[i].row, moves[i].col, getMark());
+		moves[i].score = miniMaxAB(board, 1, look_ahead-1, threshold, INT_MAX, getOppMark()).score;
+		if (!context_.stopped() && moves[i].score > threshold){
+			PvLine line(moves[i]);
+			line.pv.push_back(Move(moves[i].row, moves[i].col));
+			context_.appendPv(1, line.pv);
+			int position = result.size();
+			while (position > 0 && result[position-1].move.score < line.move.score){
+				position--;
+			}
+			result.insert(result.begin() + position, line);
+			if (static_cast<int>(result.size()) > lines){
+				result.pop_back();
+			}
+		}
+		board.removeMove(moves[i].row, moves[i].col);
+		if (context_.stopped()){
+			return;
+		}
+	}
+
+	context_.store(key, toTableScore(result[0].move.score, 0), look_ahead, SearchContext::kExact,
+			result[0].move.row, result[0].move.col);
+	for (int i=0,max=result.size(); i<max; i++){
+		extendPv(board, result[i].pv);
+	}
+}
+
+/*
+ * extendPv() - continues a principal variation cut short by a transposition table cut-off with the best moves of
+ * exact transposition table entries, as long as the game goes on. The board is left unchanged.
  */
-void AiPlayer::performMove(Board& board, TUI& ui){
+void AiPlayer::extendPv(Board& board, std::vector<Move>& pv) const{
 	char mark = getMark();
-	AiMove best_move = miniMaxAB(board, 0, kLookAhead, INT_MIN, INT_MAX, mark);
+	int played = 0;
+	for (int max=pv.size(); played<max && board.validMove(pv[played].row, pv[played].col); played++){
+		board.makeMove(pv[played].row, pv[played].col, mark);
+		mark = (mark == 'X') ? 'O' : 'X';
+	}
+	while (played == static_cast<int>(pv.size()) && board.evaluateBoard() == Board::PLAY){
+		const TableEntry* entry = context_.probe(positionKey(board, mark));
+		if (entry == NULL || entry->bound != SearchContext::kExact || !board.validMove(entry->row, entry->col)){
+			break;
+		}
+		pv.push_back(Move(entry->row, entry->col));
+		board.makeMove(entry->row, entry->col, mark);
+		mark = (mark == 'X') ? 'O' : 'X';
+		played++;
+	}
+	for (int i=played-1; i>=0; i--){
+		board.removeMove(pv[i].row, pv[i].col);
+	}
+}
 
-	std::ostringstream turn_msg;
-	turn_msg << "\nIts the turn of Player " <<  mark << ". \n"
-			 << "Moving to [column|row]: [" << best_move.col << "|" << best_move.row <<"]";
-	ui.message(turn_msg.str());
+/*
+ * newGame() - resets the search context (transposition table, killer moves, history), called between games.
+ */
+void AiPlayer::newGame(){
+	context_.reset();
+}
+
+/*
+ * setLookAhead() - sets the look ahead used by performMove(), e.g. to compare players of different strength
+ */
+void AiPlayer::setLookAhead(const int look_ahead){
+	look_ahead_ = look_ahead;
+}
+
+/*
+ * getLookAhead() - returns the look ahead used by performMove()
+ */
+int AiPlayer::getLookAhead() const{
+	return look_ahead_;
+}
 
-	board.makeMove(best_move.row, best_move.col, mark);
+/*
+ * setConfig() - sets the look ahead and the selectivity of the search at once
+ */
+void AiPlayer::setConfig(const EngineConfig& config){
+	look_ahead_ = config.look_ahead;
+	options_ = config.options;
+}
+
+/*
+ * setOptions() - sets the selectivity (late move reductions, futility pruning) of the search
+ */
+void AiPlayer::setOptions(const SearchOptions& options){
+	options_ = options;
+}
+
+/*
+ * getOptions() - returns the selectivity (late move reductions, futility pruning) of the search
+ */
+const SearchOptions& AiPlayer::getOptions() const{
+	return options_;
+}
+
+/*
+ * setPositionCache() - shares the results of deep searches with other engines (processes) through the position cache.
+ * The cache is not owned by the AiPlayer, NULL switches the sharing off.
+ */
+void AiPlayer::setPositionCache(PositionCache* cache){
+	position_cache_ = cache;
+}
+
+/*
+ * setProfiler() - profiles every move of performMove() with the hardware counters, split into the phases of the search.
+ * The profiler is not owned by the AiPlayer and has to be used on one thread only, NULL switches profiling off.
+ */
+void AiPlayer::setProfiler(SearchProfiler* profiler){
+	profiler_ = profiler;
+}
+
+/*
+ * getStatistics() - returns the statistics (visited nodes, transposition table hits, cut-offs) of the last search
+ */
+const SearchStatistics& AiPlayer::getStatistics(){
+	return context_.statistics();
 }
 
 /*
@@ -72,23 +305,50 @@ int	AiPlayer::scoreMove(Board& board, const int turn) const{
 return score;
 }
 
+/*
+ * futilityCutoff() - resolves positions near the end of the look ahead from the win line counters of the board
+ * instead of searching them (futility pruning). Returns true and sets result if the position is resolved:
+ * - the player to move can complete a win line: no move scores better than winning right now (exact score),
+ * - look ahead 1: otherwise no move changes the score before the look ahead ends, the score is 0 (exact score),
+ * - look ahead 2: otherwise the player to move cannot win before the look ahead ends, so the score can only get
+ *   worse for him than 0. If 0 is already outside of the alpha-beta window the position cannot change the result
+ *   and 0 is returned as bound.
+ * Expected inputs are the board, the moves of the position, the current turn and look ahead, alpha and beta and the
+ * mark of the player to move.
+ */
+bool AiPlayer::futilityCutoff(Board& board, std::vector<AiMove>& moves, const int turn, const int look_ahead,
+		const int alpha, const int beta, const char mark, AiMove& result) const{
+	if (look_ahead > 2){
+		return false;
+	}
+	for (int i=0,max=moves.size(); i<max; i++){
+		if (board.winningMove(moves[i].row, moves[i].col, mark)){
+			result = moves[i];
+			result.score = (mark == getMark()) ? 100 - (turn+1) : -100 + (turn+1);
+			return true;
+		}
+	}
+	if (look_ahead == 1 || (mark == getMark() && alpha >= 0) || (mark != getMark() && beta <= 0)){
+		result = AiMove(0);
+		return true;
+	}
+	return false;
+}
+
 /*
 * generateMoves - method to generate all possible moves in a particular game situation
-* Expected input is a pointer to the tic-tac-toe board.
-* Output is a pointer address of a vector including all possible moves (without score) in a particular game situation.
-* Returning just the pointer provides optimization as we dont need to copy the whole vector just pass by ref.
+* Expected input is a pointer to the tic-tac-toe board and the move list to be filled.
+* The move list is a preallocated buffer of the SearchContext, so no memory is allocated while searching.
 */
-std::vector<AiMove> AiPlayer::generateMoves(Board& board) const{
-	std::vector<AiMove> moves;
+void AiPlayer::generateMoves(Board& board, std::vector<AiMove>& moves) const{
+	moves.clear();
 	for (int i=1; i<board.kRows+1; i++){
 		for (int j=1; j<board.kCols+1; j++){
 		 if (board.validMove(i,j)){
-			 AiMove move = AiMove(i,j);
-			 moves.push_back(move);
+			 moves.push_back(AiMove(i,j));
 		 }
 		}
 	}
-	return moves;
 }
 
 /*
@@ -102,41 +362,216 @@ std::vector<AiMove> AiPlayer::generateMoves(Board& board) const{
  	}
  }
 
+/*
+ * positionKey() - returns the transposition table key of the board with the player with mark to move
+ */
+uint64_t AiPlayer::positionKey(const Board& board, const char mark) const{
+	const uint64_t kOToMove = 0xD6E8FEB86659FD93ULL;	//distinguishes equal boards with different players to move
+	return mark == 'O' ? board.getHash() ^ kOToMove : board.getHash();
+}
+
+/*
+ * cacheKey() - returns the position cache key of the board with the player with mark to move.
+ * Rotated and mirrored positions share the key (canonical hash).
+ */
+uint64_t AiPlayer::cacheKey(const Board& board, const char mark) const{
+	const uint64_t kOToMove = 0xD6E8FEB86659FD93ULL;	//distinguishes equal boards with different players to move
+	return mark == 'O' ? board.getCanonicalHash() ^ kOToMove : board.getCanonicalHash();
+}
+
+/*
+ * toTableScore() - scores depend on the turn the game ends (100 - turn), turn being counted from the root of the search.
+ * The transposition table stores them relative to the stored position instead, so they stay valid for later searches.
+ */
+int AiPlayer::toTableScore(const int score, const int turn){
+	if (score > 0){
+		return score + turn;
+	} else if (score < 0){
+		return score - turn;
+	}
+	return score;
+}
+
+/*
+ * fromTableScore() - converts a score stored by toTableScore() back to a score relative to the root of the search
+ */
+int AiPlayer::fromTableScore(const int score, const int turn){
+	if (score > 0){
+		return score - turn;
+	} else if (score < 0){
+		return score + turn;
+	}
+	return score;
+}
+
 /*
  * miniMaxAB() - (recursive) MiniMax algorithm with cut-off.
  * Expected inputs are a pointer to the tic-tac-toe board, the current turn (used for scoring),
  * the current look ahead level, current alpha and beta value for cut-off, the mark of the currently moving player.
  * Output is the best possible move for the current board within the lookahead limit.
+ * Results are stored in the transposition table of the SearchContext, positions already searched deep enough
+ * are not searched again. Moves are ordered by the SearchContext (best move, killer moves, history) to cut-off early.
  *
  * as introduced here: http://www3.ntu.edu.sg/home/ehchua/programming/java/javagame_tictactoe_ai.html
  * and here: http://neverstopbuilding.com/minimax
  */
 AiMove AiPlayer::miniMaxAB(Board& board, int turn, int look_ahead, int alpha, int beta, char mark) {
-	std::vector<AiMove> moves = generateMoves (board);
-	int best_move = 0;
+	SearchStatistics& statistics = context_.statistics();
+	statistics.nodes++;
+	SearchProfiler::Scope node_scope(profiler_, SearchProfiler::kRecursion, turn);	// no-op unless profiling
+	context_.clearPv(turn);
+
+	if (context_.stopped()){							// cancelled - the result will be discarded by searchMove()
+		return AiMove(0);
+	}
+	{
+		SearchProfiler::Scope evaluation_scope(profiler_, SearchProfiler::kEvaluation, turn);
+		if ( board.evaluateBoard() != Board::PLAY || look_ahead == 0){
+			return AiMove(scoreMove(board, turn));
+		}
+	}
 
-	if ( board.evaluateBoard() != Board::PLAY || look_ahead == 0){
-		return AiMove(scoreMove(board, turn));
+	// look the position up in the transposition table
+	const int alpha_orig = alpha;
+	const int beta_orig = beta;
+	const uint64_t key = positionKey(board, mark);
+	int table_row = 0;
+	int table_col = 0;
+	const TableEntry* entry = context_.probe(key);
+	if (entry != NULL){
+		statistics.table_hits++;
+		table_row = entry->row;
+		table_col = entry->col;
+		if (turn > 0 && entry->depth >= look_ahead){		// the root has to search to return a move
+			AiMove table_move = AiMove(entry->row, entry->col);
+			table_move.score = fromTableScore(entry->score, turn);
+			if (entry->bound == SearchContext::kExact
+					|| (entry->bound == SearchContext::kLower && table_move.score >= beta)
+					|| (entry->bound == SearchContext::kUpper && table_move.score <= alpha)){
+				statistics.table_cutoffs++;
+				return table_move;
+			}
+		}
 	}
+
+	// look deep positions up in the cache shared with other engines, its scores are for the player to move
+	const bool use_cache = position_cache_ != NULL && look_ahead >= kCacheMinLookAhead;
+	const uint64_t cache_key = use_cache ? cacheKey(board, mark) : 0;
+	CachedPosition cached;
+	if (use_cache && turn > 0 && position_cache_->probe(cache_key, cached) && cached.depth >= look_ahead){
+		AiMove cached_move = AiMove(fromTableScore(mark == getMark() ? cached.score : -cached.score, turn));
+		int bound = cached.bound;
+		if (mark != getMark() && bound != SearchContext::kExact){		//a lower bound for the opponent is an upper bound for me
+			bound = (bound == SearchContext::kLower) ? SearchContext::kUpper : SearchContext::kLower;
+		}
+		if (bound == SearchContext::kExact
+				|| (bound == SearchContext::kLower && cached_move.score >= beta)
+				|| (bound == SearchContext::kUpper && cached_move.score <= alpha)){
+			statistics.cache_cutoffs++;
+			return cached_move;
+		}
+	}
+
+	std::vector<AiMove>& moves = context_.moveBuffer(turn);
+	{
+		SearchProfiler::Scope generation_scope(profiler_, SearchProfiler::kMoveGeneration, turn);
+		generateMoves (board, moves);
+	}
+
+	AiMove resolved_move = AiMove(0);
+	if (options_.futility_pruning && turn > 0){
+		SearchProfiler::Scope evaluation_scope(profiler_, SearchProfiler::kEvaluation, turn);
+		if (futilityCutoff(board, moves, turn, look_ahead, alpha, beta, mark, resolved_move)){
+			statistics.futility_cutoffs++;
+			return resolved_move;
+		}
+	}
+
+	{
+		SearchProfiler::Scope generation_scope(profiler_, SearchProfiler::kMoveGeneration, turn);
+		context_.orderMoves(moves, turn, table_row, table_col);
+	}
+	int best_move = 0;
+	const bool reduce = options_.late_move_reductions && turn > 0 && look_ahead >= options_.reduction_min_look_ahead;
+
 	for (int i=0,max=moves.size(); i<max; i++){
+		// moves which win, block a win or threaten to win are never reduced, the reduced search would miss the tactics
+		const char opponent = (mark == getMark()) ? getOppMark() : getMark();
+		const bool reduce_move = reduce && i >= options_.reduction_min_move
+				&& !board.winningMove(moves[i].row, moves[i].col, mark)
+				&& !board.winningMove(moves[i].row, moves[i].col, opponent)
+				&& !board.threatMove(moves[i].row, moves[i].col, mark);
 		board.makeMove(moves[i].row,moves[i].col,mark);		// simulate move on board
-		if (mark == getMark()){								// if its my turn I am maximizing
+
+		// late move reductions - moves ordered late are unlikely to be the best, search them one ply shallower with a
+		// null window first. Only if the move turns out to be better than alpha (beta) it is searched again normally.
+		bool reduced_fail = false;
+		if (reduce_move && mark == getMark() && alpha != INT_MIN){
+			statistics.reductions++;
+			moves[i].score = miniMaxAB(board, turn+1, look_ahead-2, alpha, alpha+1, getOppMark()).score;
+			reduced_fail = moves[i].score <= alpha;
+			statistics.re_searches += reduced_fail ? 0 : 1;
+		} else if (reduce_move && mark != getMark() && beta != INT_MAX){
+			statistics.reductions++;
+			moves[i].score = miniMaxAB(board, turn+1, look_ahead-2, beta-1, beta, getMark()).score;
+			reduced_fail = moves[i].score >= beta;
+			statistics.re_searches += reduced_fail ? 0 : 1;
+		}
+
+		if (reduced_fail){
+			// the reduced search shows the move does not improve alpha (beta) - no full search needed
+		}else if (mark == getMark()){						// if its my turn I am maximizing
 			moves[i].score = miniMaxAB(board, turn+1, look_ahead-1, alpha, beta, getOppMark()).score; // call minMaxAB recursively to generate score (switching players)
 			if (moves[i].score > alpha){					// do we have a higher score than alpha then
 				alpha = moves[i].score;						// assign higher score to alpha
 				best_move = i;								// change index of best move
+				context_.updatePv(turn, moves[i]);			// the move and the PV of its reply
 			}
 		}else{												// if its the turn of my opponent he is minimizing
 			moves[i].score = miniMaxAB(board, turn+1, look_ahead-1, alpha, beta, getMark()).score; // call minMaxAB recursively to generate score (switching players)
 			if (moves[i].score < beta){						// is there a lower score than beta then
 				beta = moves[i].score;						// assign lower score to beta
 				best_move = i;								// change index of best move
+				context_.updatePv(turn, moves[i]);			// the move and the PV of its reply
 			}
 		}
 		board.removeMove(moves[i].row,moves[i].col);		// remove move from board
+		if (context_.stopped()){							// do not store incomplete results
+			return moves[best_move];
+		}
 		if (alpha >= beta){									// cut-off move generation and scoring if alpha is greater or equal to beta
+			statistics.beta_cutoffs++;
+			context_.addCutoff(moves[i], turn, look_ahead);	// remember the move for ordering of the sibling positions
 			break;											// as a perfect player will not choose this path
 		}
 	}
+
+	// store the result - scores outside of the alpha-beta window only prove the window bound
+	SearchContext::Bound bound = SearchContext::kExact;
+	int table_score = moves[best_move].score;
+	if (table_score <= alpha_orig){
+		bound = SearchContext::kUpper;
+		table_score = alpha_orig;
+	} else if (table_score >= beta_orig){
+		bound = SearchContext::kLower;
+		table_score = beta_orig;
+	}
+	if (table_score != INT_MIN && table_score != INT_MAX){
+		context_.store(key, toTableScore(table_score, turn), look_ahead, bound, moves[best_move].row, moves[best_move].col);
+		if (use_cache){
+			// exact results are the game value if a win was found or the search reached the end of the game
+			// (unless late move reductions made the search inexact)
+			bool solved = bound == SearchContext::kExact && !options_.late_move_reductions
+					&& (table_score != 0 || look_ahead >= static_cast<int>(moves.size()));
+			CachedPosition position;
+			position.score = (mark == getMark()) ? toTableScore(table_score, turn) : -toTableScore(table_score, turn);
+			position.depth = solved ? PositionCache::kSolved : look_ahead;
+			position.bound = bound;
+			if (mark != getMark() && bound != SearchContext::kExact){
+				position.bound = (bound == SearchContext::kLower) ? SearchContext::kUpper : SearchContext::kLower;
+			}
+			position_cache_->store(cache_key, position);
+		}
+	}
 return moves[best_move];
 }
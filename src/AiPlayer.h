@@ -15,16 +15,17 @@
 
 #include "Player.h"
 #include "Board.h"
+#include "SearchContext.h"
+#include "PositionCache.h"
+#include "SearchProfiler.h"
 
 #include <vector>
 #include <ctime>
 
-struct AiMove {											// Create a struct to store/return the AiMoves
-	AiMove(int scr) : row(0), col(0),score(scr){};				// constructor with score
-	AiMove(int row, int col) : row(row), col(col), score(0){};	// constructor with coordinates, w/o score
-	int row;
-	int col;
-	int score;
+struct EngineConfig {							// Settings of an AiPlayer, shared by all players using them
+	EngineConfig();								// default AiPlayer settings
+	int look_ahead;								// look ahead of every move
+	SearchOptions options;						// selectivity of the search
 };
 
 class AiPlayer: public Player {
@@ -41,15 +42,47 @@ public:
 	AiPlayer(const char mark);				//Constructor, taking the mark of the player as input
 	virtual ~AiPlayer();					//Destructor
 
-	void performMove(Board& board, TUI& ui);//Places the best possible move generated by the miniMax method
+	Move performMove(Board& board, TUI& ui);//Places the best possible move generated by the miniMax method
 											//on the board. Overrides Player::performMove()
+	bool isInteractive() const;				//The AiPlayer does not need the TUI. Overrides Player::isInteractive()
+	AiMove searchMove(Board& board, const SearchLimits& limits);	//Searches the best move for the board within the limits
+											//(iterative deepening), the board is left unchanged. Throws
+											//std::logic_error if the game is over
+	//Searches the best lines root moves of the board with exact scores and principal variations (multi-PV), best first
+	std::vector<PvLine> analyze(Board& board, const SearchLimits& limits, const int lines);
+	void newGame();							//Resets the search context. Overrides Player::newGame()
+	void setLookAhead(const int look_ahead);	//Sets the look ahead of performMove() (kLookAhead by default)
+	int getLookAhead() const;				//Returns the look ahead of performMove()
+	void setConfig(const EngineConfig& config);	//Sets the look ahead and the selectivity of the search
+	void setOptions(const SearchOptions& options);	//Sets the selectivity (pruning) of the search
+	const SearchOptions& getOptions() const;	//Returns the selectivity (pruning) of the search
+	void setPositionCache(PositionCache* cache);	//Shares deep search results through the cache (NULL = off), not owned
+	void setProfiler(SearchProfiler* profiler);	//Profiles the moves of performMove() (NULL = off), not owned
+	const SearchStatistics& getStatistics();//Returns the statistics of the last search
 private:
+	SearchContext context_;					//search state kept between the moves of a game
+	SearchOptions options_;					//selectivity of the search
+	int look_ahead_;						//look ahead of performMove()
+	PositionCache* position_cache_;			//cache shared with other engine processes or NULL
+	SearchProfiler* profiler_;				//hardware counter profiling or NULL
+	static const int kCacheMinLookAhead = 4;	//only searches at least this deep are worth sharing
+
 	//minimax algorithm with alpha beta pruning - used to generate, score and select the best possible move for the Ai
 	AiMove miniMaxAB(Board& board, const int turn, const int look_ahead, const int alpha, const int beta, const char mark);
 
+	//multi-PV root of analyze() - searches every root move against the score of the lines-th best move
+	void analyzeRoot(Board& board, const int look_ahead, const int lines, std::vector<PvLine>& result);
+	void extendPv(Board& board, std::vector<Move>& pv) const;	//continues a PV with exact transposition table moves
+
 	int	scoreMove(Board& board, const int turn) const;		//used to score moves for the miniMaxAB method
-	std::vector<AiMove> generateMoves(Board& board) const;	//used to generate all possible moves for a turn called by the miniMaxAB method
+	bool futilityCutoff(Board& board, std::vector<AiMove>& moves, const int turn, const int look_ahead,
+			const int alpha, const int beta, const char mark, AiMove& result) const;	//resolves the last two plies of miniMaxAB
+	void generateMoves(Board& board, std::vector<AiMove>& moves) const;	//used to generate all possible moves for a turn called by the miniMaxAB method
 	char getOppMark() const;								//used to get the mark of the opponent called by the miniMaxAB method
+	uint64_t positionKey(const Board& board, const char mark) const;	//transposition table key of the board with mark to move
+	uint64_t cacheKey(const Board& board, const char mark) const;		//position cache key of the board with mark to move
+	static int toTableScore(const int score, const int turn);	//converts a score to be stored in the transposition table
+	static int fromTableScore(const int score, const int turn);	//converts a score read from the transposition table
 };
 
 #endif /* AIPLAYER_H_ */
@@ -0,0 +1,183 @@
+/*
+ * BatchEvaluator.cpp
+ *
+ * BatchEvaluator class implementation.
+ * The BatchEvaluator evaluates batches of positions stored as X and O bitmasks against the win line masks.
+ */
+
+#include "BatchEvaluator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/*
+ * BatchEvaluator constructor - builds the bitmask of every win line (rows, columns, both diagonals) in the same
+ * order as the Board counts them, for small boards also the table of all positions. Nothing is built for boards
+ * which do not fit into the masks.
+ */
+BatchEvaluator::BatchEvaluator() : full_mask_(0) {
+	if (!kAvailable){
+		return;
+	}
+	const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};	// right, down, down right, down left
+	int count = 0;
+	for (int i=0; i<Board::kRows; i++){
+		for (int j=0; j<Board::kCols; j++){
+			full_mask_ |= 1ULL << (i*Board::kCols + j);
+			for (int d=0; d<4; d++){
+				int last_i = i + directions[d][0]*(Board::kWinLine-1);
+				int last_j = j + directions[d][1]*(Board::kWinLine-1);
+				if (last_i < 0 || last_i >= Board::kRows || last_j < 0 || last_j >= Board::kCols){
+					continue;
+				}
+				uint64_t mask = 0;
+				for (int k=0; k<Board::kWinLine; k++){
+					mask |= 1ULL << ((i + directions[d][0]*k)*Board::kCols + j + directions[d][1]*k);
+				}
+				line_masks_[count++] = mask;
+			}
+		}
+	}
+
+	if (kFields <= kMaxTableFields){
+		// precompute all 3^kFields assignments of the fields (also the ones no game reaches) with the line kernel
+		ternary_.resize(1u << std::min(kFields, static_cast<int>(kMaxTableFields)));
+		for (uint32_t mask=0; mask<ternary_.size(); mask++){
+			uint32_t value = 0;
+			for (int bit=kFields-1; bit>=0; bit--){
+				value = 3*value + ((mask >> bit) & 1);
+			}
+			ternary_[mask] = value;
+		}
+		uint32_t positions = 1;
+		for (int i=0; i<kFields; i++){
+			positions *= 3;
+		}
+		std::vector<uint64_t> x(positions, 0);
+		std::vector<uint64_t> o(positions, 0);
+		for (uint32_t index=0; index<positions; index++){
+			uint32_t rest = index;
+			for (int bit=0; bit<kFields; bit++, rest/=3){
+				x[index] |= static_cast<uint64_t>(rest % 3 == 1) << bit;
+				o[index] |= static_cast<uint64_t>(rest % 3 == 2) << bit;
+			}
+		}
+		table_status_.resize(positions);
+		table_score_.resize(positions);
+		evaluateLines(&x[0], &o[0], positions, &table_status_[0], &table_score_[0]);
+	}
+}
+
+/*
+ * BatchEvaluator destructor
+ */
+BatchEvaluator::~BatchEvaluator() {
+}
+
+/*
+ * pack() - returns the bitmasks of the X and O fields of the board
+ */
+void BatchEvaluator::pack(const Board& board, uint64_t& x, uint64_t& o){
+	x = board.getMarks('X');
+	o = board.getMarks('O');
+}
+
+/*
+ * evaluate() - evaluates every position of the batch: results.status gets the Board::BoardStatus and results.score
+ * the heuristic score. Batches of at least kMinPositionsPerThread positions per thread are split into equal ranges,
+ * one per thread (threads = 0 - one per hardware thread), the calling thread evaluates the first one.
+ * Throws std::logic_error for boards with more than 64 fields.
+ */
+void BatchEvaluator::evaluate(const PositionBatch& batch, EvaluationBatch& results, const int threads) const{
+	if (!kAvailable){
+		throw std::logic_error("BATCH EVALUATOR - boards with more than 64 fields do not fit into the masks");
+	}
+	size_t count = threads;
+	if (threads <= 0){
+		count = std::max(1u, std::thread::hardware_concurrency());
+	}
+	count = std::max<size_t>(1, std::min(count, batch.count / kMinPositionsPerThread));
+
+	const size_t range = (batch.count + count - 1) / count;
+	std::vector<std::thread> workers;
+	for (size_t t=1; t<count; t++){
+		size_t begin = std::min(batch.count, t*range);
+		size_t end = std::min(batch.count, begin + range);
+		workers.push_back(std::thread(&BatchEvaluator::evaluateRange, this, std::cref(batch), std::ref(results), begin, end));
+	}
+	evaluateRange(batch, results, 0, std::min(batch.count, range));
+	for (int i=0,max=workers.size(); i<max; i++){
+		workers[i].join();
+	}
+}
+
+/*
+ * evaluateRange() - evaluates the positions begin to end - 1 of the batch with the kernel of the board size
+ */
+void BatchEvaluator::evaluateRange(const PositionBatch& batch, EvaluationBatch& results, size_t begin, size_t end) const{
+	if (begin >= end){
+		return;
+	}
+	if (!table_status_.empty()){
+		evaluateTable(batch.x + begin, batch.o + begin, end - begin, results.status + begin, results.score + begin);
+	} else {
+		evaluateLines(batch.x + begin, batch.o + begin, end - begin, results.status + begin, results.score + begin);
+	}
+}
+
+/*
+ * evaluateTable() - the kernel of small boards: two lookups turn the masks into the base 3 index of the position
+ * (X = 1, O = 2 per field), its status and score are read from the precomputed table
+ */
+void BatchEvaluator::evaluateTable(const uint64_t* x, const uint64_t* o, const size_t count, unsigned char* status,
+		int32_t* score) const{
+	const uint32_t* ternary = &ternary_[0];
+	const uint64_t field_mask = ternary_.size() - 1;
+	for (size_t i=0; i<count; i++){
+		const uint32_t index = ternary[x[i] & field_mask] + 2*ternary[o[i] & field_mask];
+		status[i] = table_status_[index];
+		score[i] = table_score_[index];
+	}
+}
+
+/*
+ * evaluateLines() - the win line kernel: every position is tested against the bitmask of every win line without
+ * branches. Per position it counts the open lines of both players, detects completed lines and sums the line
+ * weights; the status follows the rules of Board::evaluateBoard() (X wins before O wins, then full board or no
+ * open line left means DRAW). Compiled for AVX2, POPCNT and plain x86-64, selected at run time (GCC ifunc).
+ */
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+__attribute__((target_clones("avx2","popcnt","default")))
+#endif
+void BatchEvaluator::evaluateLines(const uint64_t* x, const uint64_t* o, const size_t count, unsigned char* status,
+		int32_t* score) const{
+	for (size_t i=0; i<count; i++){
+		const uint64_t xi = x[i];
+		const uint64_t oi = o[i];
+		int32_t sum = 0, x_open = 0, o_open = 0, x_won = 0, o_won = 0;
+		for (int line=0; line<Board::kLineCount; line++){
+			const uint64_t mask = line_masks_[line];
+			const uint64_t x_line = xi & mask;
+			const uint64_t o_line = oi & mask;
+			const int32_t x_only = (o_line == 0);			// the line is still open for X
+			const int32_t o_only = (x_line == 0);
+			// weight 8^(marks-1), 0 without marks, capped at 8^6 to keep the sum far below kWinScore
+			const int32_t x_weight = (1 << std::min(3*__builtin_popcountll(x_line), 21)) >> 3;
+			const int32_t o_weight = (1 << std::min(3*__builtin_popcountll(o_line), 21)) >> 3;
+			sum += x_weight*x_only - o_weight*o_only;
+			x_open += x_only;
+			o_open += o_only;
+			x_won |= (x_line == mask);
+			o_won |= (o_line == mask);
+		}
+		const int32_t full = ((xi | oi) & full_mask_) == full_mask_;
+		const int32_t draw = full | ((x_open == 0) & (o_open == 0));
+		const int32_t o_wins = o_won & !x_won;
+		const int32_t draws = draw & !x_won & !o_won;
+		status[i] = static_cast<unsigned char>(x_won*Board::WINX + o_wins*Board::WINO + draws*Board::DRAW);
+		const int32_t playing = !x_won & !o_won & !draw;
+		score[i] = x_won*kWinScore - o_wins*kWinScore + playing*sum;
+	}
+}
@@ -0,0 +1,72 @@
+/*
+ * BatchEvaluator.h
+ *
+ * BatchEvaluator class definition.
+ * The BatchEvaluator evaluates large numbers of independent positions at once (training and analysis data):
+ * the status of every position (same as Board::evaluateBoard()) and a static heuristic score.
+ * Positions are passed as a structure of arrays - one array of X bitmasks and one of O bitmasks (bit
+ * (row-1)*kCols + (column-1), see Board::getMarks()) - instead of Board objects, large batches are split over
+ * several threads. Positions are evaluated with one of two branchless kernels:
+ *  - small boards (up to kMaxTableFields fields, e.g. 3x3): every position is precomputed once. The X and O masks
+ *    are turned into a base 3 index of the position with two lookups, the results are read from the table.
+ *  - larger boards: the masks are tested against the bitmask of every win line. The kernel is compiled for
+ *    several instruction sets (AVX2, POPCNT, plain x86-64) and the best one for the CPU is chosen at run time.
+ * Heuristic score (view of X): every win line still open for only one player counts 8^(marks-1) for it, so each
+ * further mark in a line is worth 8 times more. Won positions score +-kWinScore, draws 0.
+ * Boards with more than 64 fields do not fit into the masks: the class still compiles for them (the rest of the
+ * engine supports them), but evaluate() throws.
+ */
+
+#ifndef BATCHEVALUATOR_H_
+#define BATCHEVALUATOR_H_
+
+#include "Board.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+struct PositionBatch {									// Positions to evaluate (structure of arrays)
+	PositionBatch(const uint64_t* x, const uint64_t* o, size_t count) : x(x), o(o), count(count){};
+	const uint64_t* x;									// fields of X of every position
+	const uint64_t* o;									// fields of O of every position
+	size_t count;										// number of positions
+};
+
+struct EvaluationBatch {								// Results of the positions (structure of arrays)
+	EvaluationBatch(unsigned char* status, int32_t* score) : status(status), score(score){};
+	unsigned char* status;								// Board::BoardStatus of every position
+	int32_t* score;										// heuristic score of every position (view of X)
+};
+
+class BatchEvaluator {
+public:
+	static const int32_t kWinScore = 1 << 28;			// score of a position won by X (-kWinScore won by O)
+	static const int kFields = Board::kRows*Board::kCols;
+	static const bool kAvailable = kFields <= 64;		// a position fits into 64 bit masks
+	static const int kMaxTableFields = 10;				// boards up to this size are precomputed (3^10 positions)
+	static const size_t kMinPositionsPerThread = 1 << 16;	// smaller batches are not worth another thread
+
+	BatchEvaluator();									// Constructor - builds the win line masks (and table)
+	virtual ~BatchEvaluator();							// Destructor
+
+	//evaluates all positions of the batch into results (arrays of at least batch.count entries), threads = 0 uses
+	//one thread per hardware thread. The positions are expected to be valid (no field with both marks).
+	//Throws std::logic_error if the board has more than 64 fields (kAvailable is false).
+	void evaluate(const PositionBatch& batch, EvaluationBatch& results, const int threads = 0) const;
+	static void pack(const Board& board, uint64_t& x, uint64_t& o);	// bitmasks of a board
+private:
+	void evaluateRange(const PositionBatch& batch, EvaluationBatch& results, size_t begin, size_t end) const;
+	void evaluateLines(const uint64_t* x, const uint64_t* o, const size_t count, unsigned char* status,
+			int32_t* score) const;						// the win line kernel
+	void evaluateTable(const uint64_t* x, const uint64_t* o, const size_t count, unsigned char* status,
+			int32_t* score) const;						// the lookup kernel of small boards
+
+	uint64_t line_masks_[Board::kLineCount];			// fields of every win line
+	uint64_t full_mask_;								// all fields of the board
+	std::vector<uint32_t> ternary_;						// small boards: base 3 value of every field mask (1 per field)
+	std::vector<unsigned char> table_status_;			// small boards: status of every position (by base 3 index)
+	std::vector<int32_t> table_score_;					// small boards: score of every position (by base 3 index)
+};
+
+#endif /* BATCHEVALUATOR_H_ */
@@ -11,7 +11,85 @@
 
 #include "Board.h"
 
-#include <sstream>
+#include <algorithm>
+
+
+namespace {
+
+/*
+ * ZobristTable - random 64 bit keys for every (field, mark) combination used to hash the board.
+ * The keys are generated once at program start with a fixed seed (splitmix64), so hashes are
+ * reproducible between runs.
+ */
+struct ZobristTable {
+	uint64_t keys[Board::kRows][Board::kCols][2];		//[row][col][0 = X, 1 = O]
+
+	ZobristTable() {
+		uint64_t seed = 0x9E3779B97F4A7C15ULL;
+		for (int i=0; i<Board::kRows; i++){
+			for (int j=0; j<Board::kCols; j++){
+				for (int k=0; k<2; k++){
+					seed += 0x9E3779B97F4A7C15ULL;		//splitmix64 step
+					uint64_t z = seed;
+					z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+					z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+					keys[i][j][k] = z ^ (z >> 31);
+				}
+			}
+		}
+	}
+};
+
+const ZobristTable kZobrist;
+
+/*
+ * WinLines - all win lines of the board (kWinLine fields in a row, column or diagonal) and the lines every field is part of.
+ * Used to count the marks of each player per line incrementally.
+ */
+struct WinLines {
+	static const int kMaxLinesPerField = 4*Board::kWinLine;	//at most kWinLine lines per direction go through a field
+	int count;
+	int field_lines[Board::kRows][Board::kCols][kMaxLinesPerField];	//indexes of the lines through a field
+	int field_line_count[Board::kRows][Board::kCols];
+
+	WinLines() : count(0) {
+		for (int i=0; i<Board::kRows; i++){
+			for (int j=0; j<Board::kCols; j++){
+				field_line_count[i][j] = 0;
+			}
+		}
+		for (int i=0; i<Board::kRows; i++){
+			for (int j=0; j<Board::kCols; j++){
+				addLine(i, j, 0, 1);		//row going right
+				addLine(i, j, 1, 0);		//column going down
+				addLine(i, j, 1, 1);		//diagonal going down and right
+				addLine(i, j, 1, -1);		//diagonal going down and left
+			}
+		}
+	}
+
+	//adds the line starting at field i, j going in direction di, dj if it fits on the board
+	void addLine(const int i, const int j, const int di, const int dj){
+		if ((di != 0 && Board::kRows < Board::kWinLine) || (dj != 0 && Board::kCols < Board::kWinLine)){
+			return;							//no line of this direction fits on the board
+		}
+		int last_i = i + di*(Board::kWinLine-1);
+		int last_j = j + dj*(Board::kWinLine-1);
+		if (last_i < 0 || last_i >= Board::kRows || last_j < 0 || last_j >= Board::kCols){
+			return;
+		}
+		for (int k=0; k<Board::kWinLine; k++){
+			int& lines = field_line_count[i+di*k][j+dj*k];
+			field_lines[i+di*k][j+dj*k][lines] = count;
+			lines++;
+		}
+		count++;
+	}
+};
+
+const WinLines kWinLines;
+
+}
 
 /*
  * Board() - Constructor
@@ -39,6 +117,15 @@ void Board::resetBoard(){
 		}
 	}
 	available_moves_ = kRows*kCols;
+	hash_ = 0;
+	for (int i=0; i<kLineCount; i++){
+		line_marks_[i][0] = 0;
+		line_marks_[i][1] = 0;
+	}
+	for (int p=0; p<2; p++){
+		open_lines_[p] = kLineCount;
+		completed_lines_[p] = 0;
+	}
 }
 
 /*
@@ -47,7 +134,23 @@ void Board::resetBoard(){
  */
 void Board::makeMove(const int row, const int column, const char mark){
 	setMark(row, column, mark);			//call setMark() method
+	hash_ ^= zobristKey(row, column, mark);	//add the mark to the position hash
 	available_moves_--;					//reduce number of available moves;
+
+	//count the mark in all win lines through the field
+	int player = (mark == 'X') ? 0 : 1;
+	int opponent = 1 - player;
+	const int* lines = kWinLines.field_lines[row-1][column-1];
+	for (int k=0,max=kWinLines.field_line_count[row-1][column-1]; k<max; k++){
+		unsigned char* marks = line_marks_[lines[k]];
+		if (marks[player] == 0){						//the line was open for the opponent, now it is blocked
+			open_lines_[opponent]--;
+		}
+		marks[player]++;
+		if (marks[player] == kWinLine){
+			completed_lines_[player]++;
+		}
+	}
 }
 
 /*
@@ -56,8 +159,25 @@ void Board::makeMove(const int row, const int column, const char mark){
  * Used by AiPlayer remove simulated moves
  */
 void Board::removeMove(const int row, const int column){
+	char mark = fields_[row-1][column-1];
+	hash_ ^= zobristKey(row, column, mark);	//remove the mark from the position hash
 	setMark(row, column, kEmpty);		//call setMark() method
 	available_moves_++;					//increase number of available moves;
+
+	//remove the mark from all win lines through the field
+	int player = (mark == 'X') ? 0 : 1;
+	int opponent = 1 - player;
+	const int* lines = kWinLines.field_lines[row-1][column-1];
+	for (int k=0,max=kWinLines.field_line_count[row-1][column-1]; k<max; k++){
+		unsigned char* marks = line_marks_[lines[k]];
+		if (marks[player] == kWinLine){
+			completed_lines_[player]--;
+		}
+		marks[player]--;
+		if (marks[player] == 0){						//the line is open for the opponent again
+			open_lines_[opponent]++;
+		}
+	}
 }
 
 /*
@@ -70,10 +190,9 @@ bool Board::validMove( const int row, const int column ) const{
 	int j = column - 1;					//reduce column by 1 to get the array index
 	bool valid_move = false;
 
-	if (i > kRows-1 || j > kCols-1){	//invalid move, field outside of array
+	if (i < 0 || j < 0 || i > kRows-1 || j > kCols-1){	//invalid move, field outside of array
 		valid_move = false;
-	}
-	if (fields_[i][j] != kEmpty){		//invalid move, field already occupied
+	} else if (fields_[i][j] != kEmpty){		//invalid move, field already occupied
 		valid_move = false;
 	} else {							//valid move
 		valid_move = true;
@@ -81,6 +200,41 @@ bool Board::validMove( const int row, const int column ) const{
 	return valid_move;
 }
 
+/*
+ * winningMove() - check if placing mark on the (empty) field row, column would complete a win line.
+ * Uses the win line counters, the board is not modified.
+ */
+bool Board::winningMove(const int row, const int column, const char mark) const{
+	int player = (mark == 'X') ? 0 : 1;
+	int opponent = 1 - player;
+	const int* lines = kWinLines.field_lines[row-1][column-1];
+	for (int k=0,max=kWinLines.field_line_count[row-1][column-1]; k<max; k++){
+		const unsigned char* marks = line_marks_[lines[k]];
+		if (marks[player] == kWinLine-1 && marks[opponent] == 0){
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * threatMove() - check if placing mark on the (empty) field row, column would leave a win line with kWinLine-1 marks
+ * of the player and no mark of the opponent (a threat to win with the next move).
+ * Uses the win line counters, the board is not modified.
+ */
+bool Board::threatMove(const int row, const int column, const char mark) const{
+	int player = (mark == 'X') ? 0 : 1;
+	int opponent = 1 - player;
+	const int* lines = kWinLines.field_lines[row-1][column-1];
+	for (int k=0,max=kWinLines.field_line_count[row-1][column-1]; k<max; k++){
+		const unsigned char* marks = line_marks_[lines[k]];
+		if (marks[player] == kWinLine-2 && marks[opponent] == 0){
+			return true;
+		}
+	}
+	return false;
+}
+
 /*
  * setMark() - sets a mark in the required field
  * Inputs are row, column, mark (X, O or kEmpty)
@@ -91,29 +245,93 @@ void Board::setMark(const int row, const int column, const char mark){
 	fields_[i][j]=mark;						//set mark at index
 }
 
+/*
+ * getHash() - returns the Zobrist hash of the current position.
+ * Equal positions always have equal hashes, used by the AiPlayer to find positions in its transposition table.
+ */
+uint64_t Board::getHash() const {
+	return hash_;
+}
+
+/*
+ * getCanonicalHash() - returns the smallest Zobrist hash of all rotations and mirrorings of the position, so the
+ * symmetric positions (which have the same game value) share one hash. Computed from the whole board, not incrementally.
+ */
+uint64_t Board::getCanonicalHash() const {
+	const int symmetries = (kRows == kCols) ? 8 : 4;	//rectangular boards can only be mirrored
+	uint64_t hashes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	for (int i=0; i<kRows; i++){
+		for (int j=0; j<kCols; j++){
+			if (fields_[i][j] == kEmpty){
+				continue;
+			}
+			int k = (fields_[i][j] == 'X') ? 0 : 1;
+			int mi = kRows-1-i;		//mirrored row
+			int mj = kCols-1-j;		//mirrored column
+			hashes[0] ^= kZobrist.keys[i][j][k];
+			hashes[1] ^= kZobrist.keys[i][mj][k];
+			hashes[2] ^= kZobrist.keys[mi][j][k];
+			hashes[3] ^= kZobrist.keys[mi][mj][k];
+			if (symmetries == 8){	//transposed (square boards only, the indexes are valid then)
+				hashes[4] ^= kZobrist.keys[j % kRows][i % kCols][k];
+				hashes[5] ^= kZobrist.keys[j % kRows][mi % kCols][k];
+				hashes[6] ^= kZobrist.keys[mj % kRows][i % kCols][k];
+				hashes[7] ^= kZobrist.keys[mj % kRows][mi % kCols][k];
+			}
+		}
+	}
+	uint64_t canonical = hashes[0];
+	for (int s=1; s<symmetries; s++){
+		canonical = std::min(canonical, hashes[s]);
+	}
+	return canonical;
+}
+
+/*
+ * getMarks() - returns the fields with mark as a bitmask, bit (row-1)*kCols + (column-1) is set for every field
+ * with the mark. Larger boards are split into words of 64 fields, word 1 holds the fields 64 to 127 etc.
+ * Used to pack positions for the BatchEvaluator and the GameState.
+ */
+uint64_t Board::getMarks(const char mark, const int word) const {
+	uint64_t marks = 0;
+	for (int i=0; i<kRows; i++){
+		for (int j=0; j<kCols; j++){
+			int bit = i*kCols + j - 64*word;
+			if (bit >= 0 && bit < 64 && fields_[i][j] == mark){
+				marks |= 1ULL << bit;
+			}
+		}
+	}
+	return marks;
+}
+
+/*
+ * zobristKey() - returns the hash key of a mark (X or O) placed in the field row, column
+ */
+uint64_t Board::zobristKey(const int row, const int column, const char mark){
+	return kZobrist.keys[row-1][column-1][mark == 'X' ? 0 : 1];
+}
+
 /*
  * evaluateBoard() - returns the board status
  * Return values: 	PLAY - game goes on,
- * 					DRAW - game over noone wins,
+ * 					DRAW - game over noone wins (no moves left, or no win line can be completed by any player anymore),
  * 					WINX - game over X wins,
  * 					WINO - game over O wins
+ * The status is taken from the win line counters maintained by makeMove()/removeMove(), the board is not scanned.
  */
 Board::BoardStatus Board::evaluateBoard() const {
 
-	char winner = getWinner(kWinLine);				// get the winner if there is one
 	Board::BoardStatus status = PLAY;				// assume we can still play the board
 
-	if (winner == 'X'){ 							//player X wins
+	if (completed_lines_[0] > 0){ 					//player X wins
 		status = WINX;
-	}
-	if (winner == 'O'){								//player O wins
+	} else if (completed_lines_[1] > 0){			//player O wins
 		status = WINO;
-	}
-	if (winner == kEmpty && available_moves_ <= 0){ 	//no winner and no more moves left - DRAW
+	} else if (available_moves_ <= 0){ 				//no winner and no more moves left - DRAW
+		status = DRAW;
+	} else if (open_lines_[0] == 0 && open_lines_[1] == 0){	//no winner and every win line is blocked - dead DRAW
 		status = DRAW;
-	}
-	if (winner == kEmpty && available_moves_ > 0){  	//no winner and moves are still left - PLAY
-    	status = PLAY;
 	}
 	return status;
 }
@@ -125,6 +343,15 @@ char Board::getWinner( const int marks_in_row ) const{
 
 	char winner = kEmpty;						//initialize winner with Empty
 
+	if (marks_in_row == kWinLine){				//the win lines are counted already
+		if (completed_lines_[0] > 0){
+			winner = 'X';
+		} else if (completed_lines_[1] > 0){
+			winner = 'O';
+		}
+		return winner;
+	}
+
 	int maxrow = kRows-marks_in_row+1;				//get maxrow - to stay within the array when searching
 	int maxcol = kCols-marks_in_row+1;				//get maxcol
 
@@ -229,34 +456,48 @@ char Board::getWinner( const int marks_in_row ) const{
  *
  */
 void Board::printBoard(TUI& ui) const {
+	std::string board_text;
+	formatBoard(board_text);
+	board_text.erase(board_text.size()-1);	//TUI::message() terminates the text by a newline
+	ui.message(board_text);					//display the board
+}
+
+/*
+ * formatBoard() - appends the text of the board, as displayed by printBoard(), to out.
+ * The text is built directly in the string, so frames of several boards can be collected without extra copies.
+ */
+void Board::formatBoard(std::string& out) const {
 
 	//create the header row of the board
-	std::ostringstream header_row;
-	header_row << "\n   ";
-    for (int i=0; i<kCols; i++){
-    	header_row << "| " << i+1 << " ";
-    }
-
-	ui.message(header_row.str());			//display the header row
-
-    //create the table
-    //create the separating line
-	std::ostringstream separator;
-    for (int i=0; i<kCols; i++){
-			separator << "----";
-		}
-	separator << "---";
+	out += "\n   ";
+	for (int i=0; i<kCols; i++){
+		out += "| ";
+		appendNumber(out, i+1);
+		out += " ";
+	}
+	out += "\n";
 
-    //create the table rows
+	//create the table rows, each one preceded by the separating line
 	for (int i=0; i<kRows; i++ ){
-		std::ostringstream table_row;
-		table_row << " " << i+1 << " ";
+		out.append(4*kCols+3, '-');
+		out += "\n ";
+		appendNumber(out, i+1);
+		out += " ";
 		for (int j=0; j<kCols; j++){
-			table_row << "| ";
-				table_row << fields_[i][j] << " ";
+			out += "| ";
+			out += fields_[i][j];
+			out += " ";
 		}
-		ui.message(separator.str());		//display separator
-		ui.message(table_row.str());		//display the table row
+		out += "\n";
 	}
+}
 
+/*
+ * appendNumber() - appends the decimal digits of a non negative number to out
+ */
+void Board::appendNumber(std::string& out, const int number){
+	if (number >= 10){
+		appendNumber(out, number/10);
+	}
+	out += static_cast<char>('0' + number%10);
 }
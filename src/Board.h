@@ -14,14 +14,38 @@
 
 #include "TUI.h"
 
+#include <stdint.h>
+#include <string>
+
+// the board size and win line can be set at compile time, e.g. -DTICTACTOE_ROWS=4 -DTICTACTOE_COLS=4 -DTICTACTOE_WIN_LINE=4
+#ifndef TICTACTOE_ROWS
+#define TICTACTOE_ROWS 3
+#endif
+#ifndef TICTACTOE_COLS
+#define TICTACTOE_COLS 3
+#endif
+#ifndef TICTACTOE_WIN_LINE
+#define TICTACTOE_WIN_LINE 3
+#endif
+
+struct Move {							// coordinates of a move (row and column starting at 1)
+	Move(int row, int col) : row(row), col(col){};
+	int row;
+	int col;
+};
+
 class Board {
 public:
 	enum BoardStatus {PLAY,DRAW,WINX,WINO};	//enumeration of the board status
-	static const int kRows = 3; 			//number of rows
-	static const int kCols = 3; 			//number of cols
-	static const int kWinLine = 3; 			//define winning situation (default 3 in a row)
+	static const int kRows = TICTACTOE_ROWS; 		//number of rows
+	static const int kCols = TICTACTOE_COLS; 		//number of cols
+	static const int kWinLine = TICTACTOE_WIN_LINE; //define winning situation (default 3 in a row)
 											//an interesting game setup is a 8x8 board with 5 in a row to win, and AiPlayer kLookAhead set to 6
 	static const char kEmpty = ' ';			//define empty char to avoid mistakes
+	static const int kLineCount = ((kCols >= kWinLine) ? kRows*(kCols-kWinLine+1) : 0)	//number of possible win lines
+			+ ((kRows >= kWinLine) ? (kRows-kWinLine+1)*kCols : 0)			//(rows, columns, both diagonals),
+			+ ((kRows >= kWinLine && kCols >= kWinLine) ? 2*(kRows-kWinLine+1)*(kCols-kWinLine+1) : 0);	//none if too short
+	static_assert(kLineCount > 0, "the win line has to fit into a row or a column of the board");
 
 	Board();															//constructor - create a board for the game
 	virtual ~Board();													//destructor
@@ -31,16 +55,29 @@ public:
 	void makeMove(const int row, const int column, const char mark);	//put a mark on the board
 	void removeMove(const int row, const int column);					//remove a mark from the board - for simulations
 	bool validMove(const int row, const int column) const;				//is move valid?
+	bool winningMove(const int row, const int column, const char mark) const;	//would the (valid) move complete a win line?
+	bool threatMove(const int row, const int column, const char mark) const;	//would the (valid) move threaten to win next move?
 
 	BoardStatus evaluateBoard() const;									//return the board status as per enum Board_Status
+																		//(DRAW as soon as no win line can be completed anymore)
 	char getWinner(const int marks_in_row) const;						//return mark of the player reaching number of marks_in_row or empty
+	uint64_t getHash() const;											//return the (Zobrist) hash of the current position
+	uint64_t getCanonicalHash() const;									//return the same hash for all rotated/mirrored positions
+	uint64_t getMarks(const char mark, const int word = 0) const;		//return the fields with mark as bitmask (64 fields per word)
 
 	void printBoard(TUI& ui) const;										//print the board to screen
+	void formatBoard(std::string& out) const;							//append the text of the board (as printed) to out
 private:
 	char fields_[kRows][kCols];		//create 2d array to store the marks in
 	int available_moves_;			//track the number of available moves for board status evaluation
+	uint64_t hash_;					//Zobrist hash of the position, updated incrementally by makeMove()/removeMove()
+	unsigned char line_marks_[kLineCount][2];	//number of X [0] and O [1] marks in every win line
+	int open_lines_[2];				//win lines X [0] / O [1] can still complete (no mark of the opponent in them)
+	int completed_lines_[2];		//win lines completed by X [0] / O [1]
 
 	void setMark(const int row, const int column, const char mark);		//set a mark on the board
+	static void appendNumber(std::string& out, const int number);		//append a number to a text
+	static uint64_t zobristKey(const int row, const int column, const char mark);	//return the hash key of a mark in a field
 };
 
 #endif /* BOARD_H_ */
@@ -0,0 +1,46 @@
+/*
+ * Game.cpp
+ *
+ * Game - class implementation.
+ * The Game class runs one game of tic-tac-toe between two players and passes the events of the game to a GameSink.
+ */
+
+#include "Game.h"
+
+/*
+ * Game() - Constructor
+ * the players get their input through ui, the events of the game are passed to sink
+ */
+Game::Game(TUI& ui, GameSink& sink) : ui_(ui), sink_(sink) {
+}
+
+/*
+ * ~Game() - Destructor
+ */
+Game::~Game() {
+}
+
+/*
+ * play() - plays a game on the board until it is decided, player_x moves first.
+ * Both players are prepared for the game by Player::newGame().
+ * Returns the result of the game (DRAW, WINX or WINO).
+ */
+Board::BoardStatus Game::play(Board& board, Player& player_x, Player& player_o){
+	Player* players[2] = {&player_x, &player_o};
+	int current_player = 0;
+
+	player_x.newGame();									// reset the state of the players from the last game
+	player_o.newGame();
+	sink_.gameStarted(board);
+
+	Board::BoardStatus status = board.evaluateBoard();
+	while (status == Board::PLAY){						// while we can play
+		Move move = players[current_player]->performMove(board, ui_);	// get the move from Player or AiPlayer
+		sink_.moveMade(*players[current_player], move, board);
+		current_player = 1 - current_player;			// swap the players
+		status = board.evaluateBoard();
+	}
+
+	sink_.gameOver(status, board);
+	return status;
+}
@@ -0,0 +1,30 @@
+/*
+ * Game.h
+ *
+ * Game - class definition.
+ * The Game class runs one game of tic-tac-toe between two players: the players move in turns until the
+ * board is decided. Every event of the game is passed to a GameSink, the Game itself displays nothing.
+ * The TUI is only used by the players which need user input (human players).
+ */
+
+#ifndef GAME_H_
+#define GAME_H_
+
+#include "Board.h"
+#include "GameSink.h"
+#include "Player.h"
+#include "TUI.h"
+
+class Game {
+public:
+	Game(TUI& ui, GameSink& sink);				//Constructor - players get input through ui, events go to sink
+	virtual ~Game();							//Destructor
+
+	//plays a game on the board, player_x moves first, returns the result (DRAW, WINX or WINO)
+	Board::BoardStatus play(Board& board, Player& player_x, Player& player_o);
+private:
+	TUI& ui_;
+	GameSink& sink_;
+};
+
+#endif /* GAME_H_ */
@@ -0,0 +1,142 @@
+/*
+ * GameSink.cpp
+ *
+ * GameSink - class implementations.
+ * A GameSink receives the events of a Game (game started, move made, game over) and displays them.
+ */
+
+#include "GameSink.h"
+
+#include <cerrno>
+#include <iostream>
+#include <unistd.h>
+
+/*
+ * GameSink destructor
+ */
+GameSink::~GameSink() {
+}
+
+/*
+ * formatMoveMessage() - appends the message announcing the move of a computer player to out
+ */
+void formatMoveMessage(std::string& out, const Player& player, const Move& move){
+	out += "\nIts the turn of Player ";
+	out += player.getMark();
+	out += ". \nMoving to [column|row]: [";
+	out += std::to_string(move.col);
+	out += "|";
+	out += std::to_string(move.row);
+	out += "]\n";
+}
+
+/*
+ * formatGameOverMessage() - appends the message announcing the result of the game to out
+ */
+void formatGameOverMessage(std::string& out, const Board::BoardStatus status){
+	switch (status){
+	case Board::DRAW:
+		out += "\nGAME OVER - The game is a DRAW.\n";
+		break;
+	case Board::WINX:
+		out += "\nGAME OVER - Player X WON the game.\n";
+		break;
+	case Board::WINO:
+		out += "\nGAME OVER - Player O WON the game.\n";
+		break;
+	default:
+		// the game is over only with one of the results above - this should never happen.
+		throw "UNREACHEABLE CODE - Error in program flow";
+	}
+}
+
+/*
+ * TuiGameSink constructor - the events are displayed through the TUI ui
+ */
+TuiGameSink::TuiGameSink(TUI& ui) : ui_(ui) {
+}
+
+/*
+ * gameStarted() - displays the empty board
+ */
+void TuiGameSink::gameStarted(const Board& board){
+	board.printBoard(ui_);
+}
+
+/*
+ * moveMade() - announces the moves of the computer (a human player has just typed the move) and displays the board
+ */
+void TuiGameSink::moveMade(const Player& player, const Move& move, const Board& board){
+	if (!player.isInteractive()){
+		std::string message;
+		formatMoveMessage(message, player, move);
+		message.erase(message.size()-1);		//TUI::message() terminates the text by a newline
+		ui_.message(message);
+	}
+	board.printBoard(ui_);
+}
+
+/*
+ * gameOver() - displays the result of the game
+ */
+void TuiGameSink::gameOver(const Board::BoardStatus status, const Board& /*board*/){
+	std::string message;
+	formatGameOverMessage(message, status);
+	message.erase(message.size()-1);
+	ui_.message(message);
+}
+
+/*
+ * BufferedGameSink constructor - the frames are written to the file descriptor fd
+ */
+BufferedGameSink::BufferedGameSink(const int fd) : fd_(fd) {
+}
+
+/*
+ * gameStarted() - writes the empty board as one frame
+ */
+void BufferedGameSink::gameStarted(const Board& board){
+	board.formatBoard(frame_);
+	flushFrame();
+}
+
+/*
+ * moveMade() - writes the announcement of a computer move together with the board as one frame
+ */
+void BufferedGameSink::moveMade(const Player& player, const Move& move, const Board& board){
+	if (!player.isInteractive()){
+		formatMoveMessage(frame_, player, move);
+	}
+	board.formatBoard(frame_);
+	flushFrame();
+}
+
+/*
+ * gameOver() - writes the result of the game as one frame
+ */
+void BufferedGameSink::gameOver(const Board::BoardStatus status, const Board& /*board*/){
+	formatGameOverMessage(frame_, status);
+	flushFrame();
+}
+
+/*
+ * flushFrame() - writes the frame with a single write() call (repeated only if the write is interrupted or partial).
+ * std::cout is flushed first so the frame does not overtake text of the TUI (prompts of human players).
+ */
+void BufferedGameSink::flushFrame(){
+	std::cout.flush();
+	const char* data = frame_.data();
+	size_t size = frame_.size();
+	while (size > 0){
+		ssize_t written = ::write(fd_, data, size);
+		if (written < 0){
+			if (errno == EINTR){
+				continue;
+			}
+			break;						//output closed - nothing left to display to
+		}
+		data += written;
+		size -= written;
+	}
+	frame_.clear();
+}
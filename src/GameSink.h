@@ -0,0 +1,62 @@
+/*
+ * GameSink.h
+ *
+ * GameSink - class definitions.
+ * A GameSink receives the events of a Game (game started, move made, game over) and displays them.
+ * Three sinks are available:
+ * NullGameSink     - ignores all events, for games nobody is watching (e.g. AI vs. AI benchmarks).
+ * TuiGameSink      - displays the events through the TUI, this is the interactive game output.
+ * BufferedGameSink - formats every event into one frame and writes it with a single write() call.
+ */
+
+#ifndef GAMESINK_H_
+#define GAMESINK_H_
+
+#include "Board.h"
+#include "Player.h"
+#include "TUI.h"
+
+#include <string>
+
+class GameSink {
+public:
+	virtual ~GameSink();
+	virtual void gameStarted(const Board& board) = 0;										//a new game starts on the board
+	virtual void moveMade(const Player& player, const Move& move, const Board& board) = 0;	//player has moved
+	virtual void gameOver(const Board::BoardStatus status, const Board& board) = 0;		//the game has ended
+};
+
+class NullGameSink : public GameSink {
+public:
+	void gameStarted(const Board& /*board*/){}
+	void moveMade(const Player& /*player*/, const Move& /*move*/, const Board& /*board*/){}
+	void gameOver(const Board::BoardStatus /*status*/, const Board& /*board*/){}
+};
+
+class TuiGameSink : public GameSink {
+public:
+	TuiGameSink(TUI& ui);								//Constructor - the events are displayed through ui
+	void gameStarted(const Board& board);
+	void moveMade(const Player& player, const Move& move, const Board& board);
+	void gameOver(const Board::BoardStatus status, const Board& board);
+private:
+	TUI& ui_;
+};
+
+class BufferedGameSink : public GameSink {
+public:
+	BufferedGameSink(const int fd = 1);					//Constructor - the frames are written to the file descriptor fd (standard output)
+	void gameStarted(const Board& board);
+	void moveMade(const Player& player, const Move& move, const Board& board);
+	void gameOver(const Board::BoardStatus status, const Board& board);
+private:
+	void flushFrame();									//write the frame in one call and clear it
+	int fd_;
+	std::string frame_;									//text of the current frame, its capacity is reused
+};
+
+// texts shared by the sinks
+void formatMoveMessage(std::string& out, const Player& player, const Move& move);	//append the message of a computer move
+void formatGameOverMessage(std::string& out, const Board::BoardStatus status);		//append the message of the game result
+
+#endif /* GAMESINK_H_ */
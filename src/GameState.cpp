@@ -0,0 +1,99 @@
+/*
+ * GameState.cpp
+ *
+ * GameState class implementation.
+ * The GameState is the compact, trivially copyable snapshot of a game.
+ */
+
+#include "GameState.h"
+
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState has to be copyable with memcpy");
+static_assert(GameState::kWords > 1 || sizeof(GameState) <= 32, "GameState has to stay compact");
+
+/*
+ * GameState constructor - the state of a new game
+ */
+GameState::GameState() {
+	clear();
+}
+
+/*
+ * clear() - empty board, X to move
+ */
+void GameState::clear(){
+	for (int word=0; word<kWords; word++){
+		x_[word] = 0;
+		o_[word] = 0;
+	}
+	hash_ = 0;											// the hash of the empty board
+	move_count_ = 0;
+	side_to_move_ = 'X';
+	status_ = Board::PLAY;
+}
+
+/*
+ * capture() - takes the snapshot of the board with the player with mark to_move to move
+ */
+void GameState::capture(const Board& board, const char to_move){
+	int marks = 0;
+	for (int word=0; word<kWords; word++){
+		x_[word] = board.getMarks('X', word);
+		o_[word] = board.getMarks('O', word);
+		marks += __builtin_popcountll(x_[word] | o_[word]);
+	}
+	hash_ = board.getHash();
+	move_count_ = static_cast<uint16_t>(marks);
+	side_to_move_ = to_move;
+	status_ = static_cast<unsigned char>(board.evaluateBoard());
+}
+
+/*
+ * restore() - clears the board and places the marks of the snapshot, the board computes the same hash and status
+ */
+void GameState::restore(Board& board) const{
+	board.resetBoard();
+	for (int bit=0; bit<Board::kRows*Board::kCols; bit++){
+		if ((x_[bit/64] >> (bit%64)) & 1){
+			board.makeMove(bit/Board::kCols + 1, bit%Board::kCols + 1, 'X');
+		} else if ((o_[bit/64] >> (bit%64)) & 1){
+			board.makeMove(bit/Board::kCols + 1, bit%Board::kCols + 1, 'O');
+		}
+	}
+}
+
+/*
+ * getMarks() - returns the fields of the player with mark as bitmask, bit (row-1)*kCols + (column-1) - 64*word
+ */
+uint64_t GameState::getMarks(const char mark, const int word) const{
+	return (mark == 'X') ? x_[word] : (mark == 'O') ? o_[word] : 0;
+}
+
+/*
+ * getSideToMove() - returns the mark of the player to move
+ */
+char GameState::getSideToMove() const{
+	return side_to_move_;
+}
+
+/*
+ * getMoveCount() - returns the number of marks on the board
+ */
+int GameState::getMoveCount() const{
+	return move_count_;
+}
+
+/*
+ * getHash() - returns the Zobrist hash of the position (the same as Board::getHash() of the captured board)
+ */
+uint64_t GameState::getHash() const{
+	return hash_;
+}
+
+/*
+ * getStatus() - returns the status of the position (PLAY, DRAW, WINX or WINO)
+ */
+Board::BoardStatus GameState::getStatus() const{
+	return static_cast<Board::BoardStatus>(status_);
+}
@@ -0,0 +1,44 @@
+/*
+ * GameState.h
+ *
+ * GameState class definition.
+ * The GameState is the compact form of a game at rest: the fields of X and O as bitmasks, the player to move, the
+ * number of moves, the (Zobrist) hash and the status - 32 bytes for boards up to 64 fields (larger boards take
+ * one more 64 bit mask per player for every further 64 fields), trivially copyable, so it can be copied with
+ * memcpy, kept in large arrays and written to disk or sent over the network as is.
+ * A Board (with its win line counters) is only needed while a move is made: capture() takes the snapshot of a
+ * Board, restore() sets a Board up from the snapshot.
+ */
+
+#ifndef GAMESTATE_H_
+#define GAMESTATE_H_
+
+#include "Board.h"
+
+#include <stdint.h>
+
+class GameState {
+public:
+	static const int kWords = (Board::kRows*Board::kCols + 63) / 64;	// 64 bit masks per player
+
+	GameState();										// Constructor - empty board, X to move
+
+	void clear();										// empty board, X to move
+	void capture(const Board& board, const char to_move);	// snapshot of the board, to_move is the player to move
+	void restore(Board& board) const;					// sets the board to the snapshot (same hash and status)
+
+	uint64_t getMarks(const char mark, const int word = 0) const;	// fields of the player as bitmask (see Board::getMarks())
+	char getSideToMove() const;							// mark of the player to move
+	int getMoveCount() const;							// number of marks on the board
+	uint64_t getHash() const;							// Zobrist hash, the same as Board::getHash()
+	Board::BoardStatus getStatus() const;				// status as evaluated by Board::evaluateBoard()
+private:
+	uint64_t x_[kWords];								// fields of X
+	uint64_t o_[kWords];								// fields of O
+	uint64_t hash_;
+	uint16_t move_count_;
+	char side_to_move_;
+	unsigned char status_;								// Board::BoardStatus
+};
+
+#endif /* GAMESTATE_H_ */
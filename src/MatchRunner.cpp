@@ -0,0 +1,291 @@
+/*
+ * MatchRunner.cpp
+ *
+ * MatchRunner class implementation.
+ * The MatchRunner plays game pairs between two AiPlayer configurations on a pool of threads and stops the match
+ * with a sequential probability ratio test (SPRT) as soon as the result is decisive.
+ */
+
+#include "MatchRunner.h"
+#include "AiPlayer.h"
+#include "Game.h"
+#include "GameSink.h"
+#include "TUI.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+/*
+ * expectedScore() - average points per game of a player elo stronger than the opponent (logistic Elo model)
+ */
+double expectedScore(const double elo){
+	return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+/*
+ * scoreToElo() - Elo difference of a player scoring score points per game, the score is kept off 0 and 1
+ */
+double scoreToElo(const double score){
+	const double kMinScore = 0.001;
+	double clamped = std::min(std::max(score, kMinScore), 1.0 - kMinScore);
+	return -400.0 * std::log10(1.0 / clamped - 1.0);
+}
+
+/*
+ * playGame() - plays one game from the opening, player_x moves first. Returns the result of the game.
+ */
+Board::BoardStatus playGame(Game& game, const std::vector<Move>& opening, Player& player_x, Player& player_o){
+	Board board;
+	char mark = 'X';
+	for (int i=0,max=opening.size(); i<max; i++){
+		board.makeMove(opening[i].row, opening[i].col, mark);
+		mark = (mark == 'X') ? 'O' : 'X';
+	}
+	if (mark == 'X'){
+		return game.play(board, player_x, player_o);
+	}
+	return game.play(board, player_o, player_x);	// odd openings - O makes the first move of the game
+}
+
+}
+
+/*
+ * MatchResult constructor - no games played yet
+ */
+MatchResult::MatchResult() : pairs(0), wins(0), draws(0), losses(0), score(0.5), elo(0.0), elo_error(0.0),
+		llr(0.0), llr_lower(0.0), llr_upper(0.0), decision(kUndecided) {
+	for (int i=0; i<5; i++){
+		pair_points[i] = 0;
+	}
+}
+
+/*
+ * MatchRunner constructor - engine A is tested against engine B
+ */
+MatchRunner::MatchRunner(const EngineConfig& engine_a, const EngineConfig& engine_b, const MatchSettings& settings)
+	: engine_a_(engine_a), engine_b_(engine_b), settings_(settings), next_pair_(0), finished_(false) {
+}
+
+/*
+ * MatchRunner destructor
+ */
+MatchRunner::~MatchRunner() {
+}
+
+/*
+ * setOpenings() - sets the openings of the game pairs, pair i is played from opening i.
+ * The openings list the moves of both players, X first. An opening reaching the same position as an earlier one (or
+ * a rotated or mirrored copy of it, like randomOpenings()) is skipped, the deterministic players would repeat its
+ * games. Throws std::invalid_argument if a move is invalid or an
+ * opening ends the game (nothing left to play).
+ */
+void MatchRunner::setOpenings(const std::vector< std::vector<Move> >& openings){
+	std::vector< std::vector<Move> > unique;
+	std::set<uint64_t> seen;
+	for (int i=0,max=openings.size(); i<max; i++){
+		Board board;
+		char mark = 'X';
+		for (int j=0,moves=openings[i].size(); j<moves; j++){
+			if (board.evaluateBoard() != Board::PLAY || !board.validMove(openings[i][j].row, openings[i][j].col)){
+				throw std::invalid_argument("INVALID OPENING - move " + std::to_string(j+1) + " of opening "
+						+ std::to_string(i+1));
+			}
+			board.makeMove(openings[i][j].row, openings[i][j].col, mark);
+			mark = (mark == 'X') ? 'O' : 'X';
+		}
+		if (board.evaluateBoard() != Board::PLAY){
+			throw std::invalid_argument("INVALID OPENING - opening " + std::to_string(i+1) + " ends the game");
+		}
+		if (seen.insert(board.getCanonicalHash()).second){
+			unique.push_back(openings[i]);
+		}
+	}
+	openings_ = unique;
+}
+
+/*
+ * getOpeningCount() - returns the number of different openings set by setOpenings()
+ */
+int MatchRunner::getOpeningCount() const{
+	return openings_.size();
+}
+
+/*
+ * getPairLimit() - returns the number of pairs the match plays at most: max_pairs, but only one pair per opening
+ * (one pair from the empty board without openings), further pairs would repeat the games of earlier ones.
+ */
+int MatchRunner::getPairLimit() const{
+	return std::min(settings_.max_pairs, std::max(static_cast<int>(openings_.size()), 1));
+}
+
+/*
+ * randomOpenings() - generates up to count openings of plies random moves, positions which are rotated or mirrored
+ * copies of another opening and openings which end the game are skipped. The same seed gives the same openings.
+ * Fewer openings are returned if the board does not have count different ones.
+ */
+std::vector< std::vector<Move> > MatchRunner::randomOpenings(const int count, const int plies, const uint32_t seed){
+	std::vector< std::vector<Move> > openings;
+	std::set<uint64_t> seen;
+	std::mt19937 random(seed);
+	const int max_plies = std::min(plies, Board::kRows*Board::kCols - 1);
+	const int kAttempts = 100;								// attempts per opening before giving up
+
+	for (int attempt=0; attempt<count*kAttempts && static_cast<int>(openings.size())<count; attempt++){
+		Board board;
+		std::vector<Move> opening;
+		char mark = 'X';
+		while (static_cast<int>(opening.size()) < max_plies && board.evaluateBoard() == Board::PLAY){
+			std::vector<Move> free_fields;
+			for (int i=1; i<=Board::kRows; i++){
+				for (int j=1; j<=Board::kCols; j++){
+					if (board.validMove(i,j)){
+						free_fields.push_back(Move(i,j));
+					}
+				}
+			}
+			Move move = free_fields[random() % free_fields.size()];
+			board.makeMove(move.row, move.col, mark);
+			opening.push_back(move);
+			mark = (mark == 'X') ? 'O' : 'X';
+		}
+		if (board.evaluateBoard() == Board::PLAY && seen.insert(board.getCanonicalHash()).second){
+			openings.push_back(opening);
+		}
+	}
+	return openings;
+}
+
+/*
+ * run() - plays the match: the worker threads take the next pair until the SPRT is decided or getPairLimit() pairs
+ * are played. Pairs still being played when the test is decided are finished but not counted.
+ * Returns the final result, progress (optional) is called after every pair.
+ */
+MatchResult MatchRunner::run(const MatchProgress& progress){
+	next_pair_.store(0);
+	finished_.store(false);
+	result_ = MatchResult();
+	evaluate(result_, settings_);
+
+	int count = settings_.threads;
+	if (count <= 0){
+		count = std::thread::hardware_concurrency();
+	}
+	if (count <= 0){
+		count = 1;
+	}
+	count = std::min(count, std::max(getPairLimit(), 1));
+
+	std::vector<std::thread> workers;
+	for (int i=0; i<count; i++){
+		workers.push_back(std::thread(&MatchRunner::work, this, std::cref(progress)));
+	}
+	for (int i=0; i<count; i++){
+		workers[i].join();
+	}
+	return result_;
+}
+
+/*
+ * evaluate() - computes the score, the Elo estimate and the SPRT of the result from its pair counts.
+ * The pairs are the samples of the test (the two games of a pair are not independent, they share the opening).
+ * With the per game score m and its variance var the log-likelihood ratio is approximated as
+ *   LLR = N (s1 - s0) (2m - s0 - s1) / (2 var)
+ * where s0 and s1 are the expected scores of elo0 and elo1 and N the number of pairs. While all pairs have the
+ * same score (var = 0) the test stays at 0 - a match of draws only does not tell anything yet.
+ */
+void MatchRunner::evaluate(MatchResult& result, const MatchSettings& settings){
+	result.llr_lower = std::log(settings.beta / (1.0 - settings.alpha));
+	result.llr_upper = std::log((1.0 - settings.beta) / settings.alpha);
+	if (result.pairs == 0){
+		return;
+	}
+
+	double sum = 0.0;
+	double sum_squares = 0.0;
+	for (int i=0; i<5; i++){
+		double pair_score = i / 4.0;						// points of the pair per game
+		sum += result.pair_points[i] * pair_score;
+		sum_squares += result.pair_points[i] * pair_score * pair_score;
+	}
+	const double n = result.pairs;
+	const double mean = sum / n;
+	const double variance = std::max(sum_squares / n - mean * mean, 0.0);
+
+	result.score = mean;
+	result.elo = scoreToElo(mean);
+	const double score_error = 1.96 * std::sqrt(variance / n);
+	result.elo_error = (scoreToElo(mean + score_error) - scoreToElo(mean - score_error)) / 2.0;
+
+	const double kMinVariance = 1e-9;
+	if (variance < kMinVariance){
+		result.llr = 0.0;
+	} else {
+		const double s0 = expectedScore(settings.elo0);
+		const double s1 = expectedScore(settings.elo1);
+		result.llr = n * (s1 - s0) * (2.0 * mean - s0 - s1) / (2.0 * variance);
+	}
+
+	if (result.llr >= result.llr_upper){
+		result.decision = MatchResult::kAcceptH1;
+	} else if (result.llr <= result.llr_lower){
+		result.decision = MatchResult::kAcceptH0;
+	} else {
+		result.decision = MatchResult::kUndecided;
+	}
+}
+
+/*
+ * work() - worker thread. Every worker has its own players (and search contexts), it plays game pairs from the
+ * openings with A as X and then with B as X and adds them to the result.
+ */
+void MatchRunner::work(const MatchProgress& progress){
+	AiPlayer a_x('X'), a_o('O'), b_x('X'), b_o('O');
+	AiPlayer* a_players[2] = {&a_x, &a_o};
+	AiPlayer* b_players[2] = {&b_x, &b_o};
+	for (int i=0; i<2; i++){
+		a_players[i]->setConfig(engine_a_);
+		b_players[i]->setConfig(engine_b_);
+	}
+	TUI ui;													// not used, the AiPlayers need no input
+	NullGameSink sink;
+	Game game(ui, sink);
+	const std::vector<Move> empty_opening;
+	const int pair_limit = getPairLimit();
+
+	while (!finished_.load()){
+		const int pair = next_pair_.fetch_add(1);
+		if (pair >= pair_limit){
+			break;
+		}
+		const std::vector<Move>& opening = openings_.empty() ? empty_opening : openings_[pair];
+
+		Board::BoardStatus first = playGame(game, opening, a_x, b_o);		// A plays X
+		Board::BoardStatus second = playGame(game, opening, b_x, a_o);		// B plays X
+		int a_wins = (first == Board::WINX) + (second == Board::WINO);
+		int a_losses = (first == Board::WINO) + (second == Board::WINX);
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (result_.decision != MatchResult::kUndecided){				// decided while this pair was played
+			continue;
+		}
+		result_.pairs++;
+		result_.wins += a_wins;
+		result_.losses += a_losses;
+		result_.draws += 2 - a_wins - a_losses;
+		result_.pair_points[2 + a_wins - a_losses]++;					// half points: 2 per win, 1 per draw
+		evaluate(result_, settings_);
+		if (result_.decision != MatchResult::kUndecided){
+			finished_.store(true);
+		}
+		if (progress){
+			progress(result_);
+		}
+	}
+}
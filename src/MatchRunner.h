@@ -0,0 +1,98 @@
+/*
+ * MatchRunner.h
+ *
+ * MatchRunner class definition.
+ * The MatchRunner plays a match between two AiPlayer configurations (engine A and engine B) to find out whether
+ * a change makes the AI stronger. Games are played in pairs from the same opening with the colors swapped, so
+ * the advantage of the first move cancels out, and the pairs are spread over all cores.
+ * After every pair the Elo difference of A over B is estimated and a sequential probability ratio test (SPRT)
+ * decides between H0 (A is elo0 stronger) and H1 (A is elo1 stronger). The match stops as soon as one of them
+ * is accepted with the error rates alpha and beta, or after max_pairs pairs.
+ * The AiPlayers are deterministic (the same position always gives the same game), so every opening is played by one
+ * pair only: a repeated pair would count the same result again as new evidence. The match ends undecided when the
+ * openings are used up.
+ *
+ * as introduced here: A. Wald, Sequential Tests of Statistical Hypotheses (1945); the normal approximation of the
+ * log-likelihood ratio for game pairs (pentanomial) is the one used by the chess engine test frameworks.
+ */
+
+#ifndef MATCHRUNNER_H_
+#define MATCHRUNNER_H_
+
+#include "AiPlayer.h"
+#include "Board.h"
+#include "SearchContext.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+struct MatchSettings {									// Settings of the match and of the SPRT
+	MatchSettings() : threads(0), max_pairs(1000), elo0(0.0), elo1(10.0), alpha(0.05), beta(0.05){};
+	int threads;										// number of threads (0 = one per hardware thread)
+	int max_pairs;										// the match ends undecided after this many game pairs (at most
+														// one pair per opening is played)
+	double elo0;										// H0: A is elo0 stronger than B
+	double elo1;										// H1: A is elo1 stronger than B
+	double alpha;										// probability of accepting H1 when H0 is true
+	double beta;										// probability of accepting H0 when H1 is true
+};
+
+struct MatchResult {									// State of the match, from the view of engine A
+	enum Decision {kUndecided, kAcceptH0, kAcceptH1};	// result of the SPRT
+	MatchResult();
+	int pairs;											// game pairs played
+	int wins;											// games won, drawn and lost by A
+	int draws;
+	int losses;
+	int pair_points[5];									// number of pairs A scored 0, 0.5, 1, 1.5 and 2 points in
+	double score;										// average points of A per game
+	double elo;											// estimated Elo difference of A over B
+	double elo_error;									// 95% confidence interval of elo (+-)
+	double llr;											// log-likelihood ratio of H1 over H0
+	double llr_lower;									// H0 is accepted when llr falls to this bound
+	double llr_upper;									// H1 is accepted when llr reaches this bound
+	Decision decision;
+};
+
+typedef std::function<void(const MatchResult& result)> MatchProgress;	// called after every game pair
+
+class MatchRunner {
+public:
+	MatchRunner(const EngineConfig& engine_a, const EngineConfig& engine_b, const MatchSettings& settings);
+	virtual ~MatchRunner();
+
+	//sets the openings the pairs are played from, the moves of both players starting with X. Openings reaching the
+	//position of an earlier one (also rotated or mirrored) are skipped. Throws std::invalid_argument if an opening contains an invalid move or
+	//ends the game.
+	void setOpenings(const std::vector< std::vector<Move> >& openings);
+	int getOpeningCount() const;						// number of different openings set
+	int getPairLimit() const;							// pairs the match can play: max_pairs, at most one per opening
+	//generates up to count different openings (rotated and mirrored ones are the same) of plies random moves
+	static std::vector< std::vector<Move> > randomOpenings(const int count, const int plies, const uint32_t seed);
+
+	//plays the match until the SPRT is decided or getPairLimit() pairs are played, progress (optional) is called
+	//after every pair (serialized, from the worker threads). Without openings one pair from the empty board is played.
+	MatchResult run(const MatchProgress& progress = MatchProgress());
+
+	//updates the score, Elo and SPRT of the result from its game counts
+	static void evaluate(MatchResult& result, const MatchSettings& settings);
+private:
+	MatchRunner(const MatchRunner&);					// not copyable
+	MatchRunner& operator=(const MatchRunner&);
+
+	void work(const MatchProgress& progress);			// worker thread - plays pairs until the match is over
+
+	EngineConfig engine_a_;
+	EngineConfig engine_b_;
+	MatchSettings settings_;
+	std::vector< std::vector<Move> > openings_;
+	std::atomic<int> next_pair_;						// index of the next pair to play
+	std::atomic<bool> finished_;						// set when the SPRT is decided
+	std::mutex mutex_;									// guards result_
+	MatchResult result_;
+};
+
+#endif /* MATCHRUNNER_H_ */
@@ -0,0 +1,172 @@
+/*
+ * PerfCounters.cpp
+ *
+ * PerfCounters class implementation.
+ * The hardware counters are read with the Linux perf_event_open() system call, on other systems they are
+ * never available.
+ */
+
+#include "PerfCounters.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+struct CounterEvent {									// perf event of a PerfCounters::Counter
+	uint32_t type;
+	uint64_t config;
+	const char* name;
+};
+
+const CounterEvent kEvents[PerfCounters::kCounters] = {
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles"},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions"},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache misses"},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch misses"}
+};
+#endif
+
+}
+
+/*
+ * operator+=() - adds the counter values of other
+ */
+PerfSample& PerfSample::operator+=(const PerfSample& other){
+	cycles += other.cycles;
+	instructions += other.instructions;
+	cache_misses += other.cache_misses;
+	branch_misses += other.branch_misses;
+	return *this;
+}
+
+/*
+ * operator-() - returns the counts between the other (earlier) sample and this one
+ */
+PerfSample PerfSample::operator-(const PerfSample& other) const{
+	PerfSample difference;
+	difference.cycles = cycles - other.cycles;
+	difference.instructions = instructions - other.instructions;
+	difference.cache_misses = cache_misses - other.cache_misses;
+	difference.branch_misses = branch_misses - other.branch_misses;
+	return difference;
+}
+
+/*
+ * PerfCounters constructor - no counters are open until open() is called
+ */
+PerfCounters::PerfCounters() : group_size_(0) {
+	for (int i=0; i<kCounters; i++){
+		fds_[i] = -1;
+		slots_[i] = -1;
+	}
+}
+
+/*
+ * PerfCounters destructor - closes the counters
+ */
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+	for (int i=kCounters-1; i>=0; i--){					// group members before the leader
+		if (fds_[i] >= 0){
+			close(fds_[i]);
+		}
+	}
+#endif
+}
+
+/*
+ * open() - opens the counters for the calling thread (user space only, so perf_event_paranoid up to 2 allows them)
+ * and starts them. The first counter which opens leads the group, counters the CPU does not have are left out.
+ * Returns false if no counter could be opened, getError() tells why.
+ */
+bool PerfCounters::open(){
+#ifdef __linux__
+	int leader = -1;
+	for (int i=0; i<kCounters; i++){
+		struct perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = kEvents[i].type;
+		attr.config = kEvents[i].config;
+		attr.disabled = (leader < 0) ? 1 : 0;			// the group is started at once through the leader
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP;
+		int fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+		if (fd < 0){
+			if (!error_.empty()){
+				error_ += ", ";
+			}
+			error_ += std::string(kEvents[i].name) + ": " + std::strerror(errno);
+			continue;
+		}
+		if (leader < 0){
+			leader = fd;
+		}
+		fds_[i] = fd;
+		slots_[i] = group_size_++;
+	}
+	if (leader < 0){
+		return false;
+	}
+	ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	return true;
+#else
+	error_ = "perf_event_open() is only available on Linux";
+	return false;
+#endif
+}
+
+/*
+ * isAvailable() - returns true if the counter is open
+ */
+bool PerfCounters::isAvailable(const Counter counter) const{
+	return slots_[counter] >= 0;
+}
+
+/*
+ * getError() - returns the reasons of the counters which could not be opened (empty if all are open)
+ */
+const std::string& PerfCounters::getError() const{
+	return error_;
+}
+
+/*
+ * read() - reads all counters with one system call. Missing counters (or all of them if open() failed) read 0.
+ */
+void PerfCounters::read(PerfSample& sample) const{
+	uint64_t values[kCounters];
+	for (int i=0; i<kCounters; i++){
+		values[i] = 0;
+	}
+#ifdef __linux__
+	if (group_size_ > 0){
+		uint64_t group[1 + kCounters];					// number of counters followed by their values
+		int leader = fds_[0];
+		for (int i=0; leader<0 && i<kCounters; i++){
+			leader = fds_[i];
+		}
+		if (::read(leader, group, sizeof(group)) >= static_cast<ssize_t>(sizeof(uint64_t)*(1 + group_size_))){
+			for (int i=0; i<kCounters; i++){
+				if (slots_[i] >= 0){
+					values[i] = group[1 + slots_[i]];
+				}
+			}
+		}
+	}
+#endif
+	sample.cycles = values[kCycles];
+	sample.instructions = values[kInstructions];
+	sample.cache_misses = values[kCacheMisses];
+	sample.branch_misses = values[kBranchMisses];
+}
@@ -0,0 +1,50 @@
+/*
+ * PerfCounters.h
+ *
+ * PerfCounters class definition.
+ * The PerfCounters class reads the hardware performance counters of the calling thread through the Linux
+ * perf_event_open() interface: CPU cycles, instructions, cache misses and branch misses, user space only.
+ * The counters are opened as one group, so all of them are read at the same time with a single read().
+ * Where the counters are not available (other systems, virtual machines, perf_event_paranoid, seccomp) open()
+ * fails and reads return zeros - the callers keep working, only without the counter values.
+ */
+
+#ifndef PERFCOUNTERS_H_
+#define PERFCOUNTERS_H_
+
+#include <stdint.h>
+#include <string>
+
+struct PerfSample {										// Counter values, differences of two samples are the costs in between
+	PerfSample() : cycles(0), instructions(0), cache_misses(0), branch_misses(0){};
+	uint64_t cycles;
+	uint64_t instructions;
+	uint64_t cache_misses;
+	uint64_t branch_misses;
+
+	PerfSample& operator+=(const PerfSample& other);
+	PerfSample operator-(const PerfSample& other) const;
+};
+
+class PerfCounters {
+public:
+	enum Counter {kCycles, kInstructions, kCacheMisses, kBranchMisses, kCounters};
+
+	PerfCounters();										// Constructor - no counters open yet
+	virtual ~PerfCounters();							// Destructor - closes the counters
+
+	bool open();										// opens and starts the counters of the calling thread, false if none is available
+	bool isAvailable(const Counter counter) const;		// is the counter open (some CPUs lack single events)
+	const std::string& getError() const;				// why open() failed or a counter is missing
+	void read(PerfSample& sample) const;				// current values (zeros for missing counters)
+private:
+	PerfCounters(const PerfCounters&);					// not copyable
+	PerfCounters& operator=(const PerfCounters&);
+
+	int fds_[kCounters];								// file descriptor of every counter, -1 if missing
+	int slots_[kCounters];								// position of the counter in the group read, -1 if missing
+	int group_size_;									// number of open counters
+	std::string error_;
+};
+
+#endif /* PERFCOUNTERS_H_ */
@@ -51,8 +51,9 @@ char Player::getMark() const{
  * The TUI class is used for user interaction.
  * performMove() requests the move coordinates from the user, check them for validity by calling the method validMove() from the Board class and
  * invokes the method makeMove() from the Board class to place the mark on the board.
+ * Returns the move placed on the board.
  */
-void Player::performMove(Board& board, TUI& ui){
+Move Player::performMove(Board& board, TUI& ui){
 
 	//initialize variables
 	char mark = getMark();
@@ -102,4 +103,19 @@ void Player::performMove(Board& board, TUI& ui){
 			board.makeMove(row,col,mark);
 		}
 	}
+	return Move(row,col);
+}
+
+/*
+ * isInteractive() - a human player interacts through the TUI to perform a move
+ */
+bool Player::isInteractive() const{
+	return true;
+}
+
+/*
+ * newGame() - prepares the player for a new game. A human player keeps no state between games,
+ * subclasses (AiPlayer) override it to reset their state.
+ */
+void Player::newGame(){
 }
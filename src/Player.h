@@ -24,7 +24,9 @@ public:
 	virtual ~Player();								//default Destructor
 	char getMark() const;							//Get players mark
 	void setMark(const char mark);					//Set players mark called by constructor
-	virtual void performMove(Board& board, TUI& ui);//Requests user input, validates move, sets mark on board
+	virtual Move performMove(Board& board, TUI& ui);//Requests user input, validates move, sets mark on board, returns the move
+	virtual bool isInteractive() const;				//Does the player need the TUI to move (human player)?
+	virtual void newGame();							//Prepares the player for a new game
 private:
 	char players_mark_;								//Mark of the player (X or O)
 };
@@ -0,0 +1,223 @@
+/*
+ * PnSolver.cpp
+ *
+ * PnSolver class implementation.
+ * The PnSolver computes the exact game theoretic value of a position with depth-first proof-number search (df-pn)
+ * and a bounded transposition table with garbage collection.
+ *
+ * as introduced here: A. Nagai, Df-pn Algorithm for Searching AND/OR Trees and Its Applications (2002)
+ */
+
+#include "PnSolver.h"
+
+#include <algorithm>
+#include <vector>
+
+/*
+ * PnSolver constructor - max_entries limits the number of transposition table entries
+ */
+PnSolver::PnSolver(const size_t max_entries) : max_entries_(std::max<size_t>(max_entries, 1024)), goal_(kXWins),
+		nodes_(0), collections_(0) {
+	table_.reserve(max_entries_);
+}
+
+/*
+ * PnSolver destructor
+ */
+PnSolver::~PnSolver() {
+}
+
+/*
+ * solve() - returns the game theoretic value of the board with the player with mark to move.
+ * First "X wins" is proven, if that fails "X wins or draws" is proven - otherwise O wins.
+ * The board is left unchanged.
+ */
+PnSolver::Result PnSolver::solve(Board& board, const char mark){
+	nodes_ = 0;
+	collections_ = 0;
+	if (prove(board, mark, kXWins)){
+		return kWinX;
+	}
+	if (prove(board, mark, kXDraws)){
+		return kDraw;
+	}
+	return kWinO;
+}
+
+/*
+ * getNodes() - returns the number of positions searched by the last solve()
+ */
+unsigned long long PnSolver::getNodes() const{
+	return nodes_;
+}
+
+/*
+ * getCollections() - returns the number of garbage collections of the transposition table during the last solve()
+ */
+unsigned long long PnSolver::getCollections() const{
+	return collections_;
+}
+
+/*
+ * getTableSize() - returns the number of entries in the transposition table
+ */
+size_t PnSolver::getTableSize() const{
+	return table_.size();
+}
+
+/*
+ * prove() - searches until the goal is proven (returns true) or disproven (returns false)
+ */
+bool PnSolver::prove(Board& board, const char mark, const Goal goal){
+	goal_ = goal;
+	search(board, mark, kInfinity, kInfinity);
+	return lookup(board, mark).pn == 0;
+}
+
+/*
+ * search() - df-pn MID(): searches the position until its proof number reaches pn_limit or its disproof number
+ * reaches dn_limit. X is the attacker: at positions with X to move (OR nodes) the proof number is the smallest
+ * proof number of the moves and the disproof number the sum of their disproof numbers, with O to move (AND nodes)
+ * it is the other way round. The most proving move is searched with limits just below the point where another
+ * move becomes the most proving one.
+ */
+void PnSolver::search(Board& board, const char mark, const uint32_t pn_limit, const uint32_t dn_limit){
+	nodes_++;
+	const unsigned long long nodes_before = nodes_;
+	Entry entry = lookup(board, mark);
+	if (entry.pn >= pn_limit || entry.dn >= dn_limit){		// solved or over the limits already
+		return;
+	}
+
+	const bool or_node = (mark == 'X');
+	const char next_mark = or_node ? 'O' : 'X';
+	std::vector<Move> moves;
+	moves.reserve(Board::kRows*Board::kCols);
+	for (int i=1; i<=Board::kRows; i++){
+		for (int j=1; j<=Board::kCols; j++){
+			if (board.validMove(i,j)){
+				moves.push_back(Move(i,j));
+			}
+		}
+	}
+
+	while (true){
+		// collect the proof numbers of the moves: select = number to minimize, other = number to sum up
+		uint32_t best_select = kInfinity;
+		uint32_t second_select = kInfinity;
+		uint32_t best_other = 0;
+		int best_move = 0;
+		uint64_t other_sum = 0;
+		bool other_infinite = false;
+		for (int i=0,max=moves.size(); i<max; i++){
+			board.makeMove(moves[i].row, moves[i].col, mark);
+			Entry child = lookup(board, next_mark);
+			board.removeMove(moves[i].row, moves[i].col);
+			uint32_t select = or_node ? child.pn : child.dn;
+			uint32_t other = or_node ? child.dn : child.pn;
+			if (other >= kInfinity){
+				other_infinite = true;
+			}
+			other_sum += other;
+			if (select < best_select){
+				second_select = best_select;
+				best_select = select;
+				best_other = other;
+				best_move = i;
+			} else if (select < second_select){
+				second_select = select;
+			}
+		}
+		// a sum reaches infinity only if one of the moves is solved, large sums stay just below it
+		uint32_t sum = other_infinite ? kInfinity : static_cast<uint32_t>(std::min<uint64_t>(other_sum, kInfinity-1));
+		entry.pn = or_node ? best_select : sum;
+		entry.dn = or_node ? sum : best_select;
+		if (entry.pn >= pn_limit || entry.dn >= dn_limit){
+			break;
+		}
+
+		uint32_t child_pn_limit, child_dn_limit;
+		if (or_node){
+			child_pn_limit = std::min(pn_limit, second_select + 1);
+			child_dn_limit = dn_limit - entry.dn + best_other;
+		} else {
+			child_pn_limit = pn_limit - entry.pn + best_other;
+			child_dn_limit = std::min(dn_limit, second_select + 1);
+		}
+		board.makeMove(moves[best_move].row, moves[best_move].col, mark);
+		search(board, next_mark, child_pn_limit, child_dn_limit);
+		board.removeMove(moves[best_move].row, moves[best_move].col);
+	}
+
+	entry.work += nodes_ - nodes_before + 1;
+	store(positionKey(board, mark), entry);
+}
+
+/*
+ * lookup() - returns the proof numbers of a position: solved for a finished game, stored ones from the
+ * transposition table, or 1/1 for a position not searched yet
+ */
+PnSolver::Entry PnSolver::lookup(Board& board, const char mark) const{
+	Entry entry = {1, 1, 0};
+	Board::BoardStatus status = board.evaluateBoard();
+	if (status == Board::PLAY){
+		std::unordered_map<uint64_t, Entry>::const_iterator stored = table_.find(positionKey(board, mark));
+		if (stored != table_.end()){
+			entry = stored->second;
+		}
+		return entry;
+	}
+	bool proven = (status == Board::WINX) || (status == Board::DRAW && goal_ == kXDraws);
+	entry.pn = proven ? 0 : kInfinity;
+	entry.dn = proven ? kInfinity : 0;
+	return entry;
+}
+
+/*
+ * store() - stores the proof numbers of a position, collects garbage first if the table is full
+ */
+void PnSolver::store(const uint64_t key, const Entry& entry){
+	if (table_.size() >= max_entries_ && table_.find(key) == table_.end()){
+		collectGarbage();
+	}
+	table_[key] = entry;
+}
+
+/*
+ * collectGarbage() - removes (at least) half of the transposition table: the entries with the least search work
+ * behind them, which are the cheapest to search again
+ */
+void PnSolver::collectGarbage(){
+	collections_++;
+	std::vector<uint64_t> work;
+	work.reserve(table_.size());
+	for (std::unordered_map<uint64_t, Entry>::const_iterator it = table_.begin(); it != table_.end(); ++it){
+		work.push_back(it->second.work);
+	}
+	std::vector<uint64_t>::iterator median = work.begin() + work.size()/2;
+	std::nth_element(work.begin(), median, work.end());
+	const uint64_t threshold = *median;
+	for (std::unordered_map<uint64_t, Entry>::iterator it = table_.begin(); it != table_.end(); ){
+		if (it->second.work <= threshold){
+			it = table_.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+/*
+ * positionKey() - transposition table key of the board with the player with mark to move for the running proof
+ */
+uint64_t PnSolver::positionKey(const Board& board, const char mark) const{
+	const uint64_t kOToMove = 0xD6E8FEB86659FD93ULL;	//distinguishes equal boards with different players to move
+	const uint64_t kDrawGoal = 0x2545F4914F6CDD1DULL;	//distinguishes the two proofs
+	uint64_t key = board.getHash();
+	if (mark == 'O'){
+		key ^= kOToMove;
+	}
+	if (goal_ == kXDraws){
+		key ^= kDrawGoal;
+	}
+	return key;
+}
@@ -0,0 +1,57 @@
+/*
+ * PnSolver.h
+ *
+ * PnSolver class definition.
+ * The PnSolver computes the exact game theoretic value of a position (X wins, draw, O wins) with depth-first
+ * proof-number search (df-pn). Unlike AiPlayer::miniMaxAB() it has no look ahead limit, it searches until the value
+ * is proven. Two proofs are run: "X wins" and "X does not lose".
+ * The transposition table is bounded: when it is full the entries with the least search work behind them are
+ * removed (garbage collection), so long runs (hours) do not grow the memory.
+ * The board size is set at compile time (see Board.h), the solver is used by the tool tools/pn_solve.cpp.
+ */
+
+#ifndef PNSOLVER_H_
+#define PNSOLVER_H_
+
+#include "Board.h"
+
+#include <stdint.h>
+#include <unordered_map>
+
+class PnSolver {
+public:
+	enum Result {kWinX, kDraw, kWinO};					// game theoretic value of a position
+
+	PnSolver(const size_t max_entries);					// Constructor - max_entries limits the transposition table
+	virtual ~PnSolver();								// Destructor
+
+	Result solve(Board& board, const char mark);		// value of the board with the player with mark to move
+
+	unsigned long long getNodes() const;				// positions searched by the last solve()
+	unsigned long long getCollections() const;			// garbage collections of the last solve()
+	size_t getTableSize() const;						// entries in the transposition table
+private:
+	enum Goal {kXWins, kXDraws};						// proven goal: X wins / X wins or draws
+	static const uint32_t kInfinity = 1u << 30;			// proof/disproof number of solved positions
+
+	struct Entry {										// transposition table entry
+		uint32_t pn;									// proof number (moves X needs to prove the goal)
+		uint32_t dn;									// disproof number (moves O needs to disprove the goal)
+		uint64_t work;									// nodes searched below the position (for garbage collection)
+	};
+
+	bool prove(Board& board, const char mark, const Goal goal);	// true if the goal is proven, false if disproven
+	void search(Board& board, const char mark, const uint32_t pn_limit, const uint32_t dn_limit);	// df-pn MID()
+	Entry lookup(Board& board, const char mark) const;	// proof numbers of a position (terminal, stored or new)
+	void store(const uint64_t key, const Entry& entry);	// store a position, collect garbage when full
+	void collectGarbage();								// remove the half of the entries with the least work
+	uint64_t positionKey(const Board& board, const char mark) const;
+
+	std::unordered_map<uint64_t, Entry> table_;			// transposition table
+	size_t max_entries_;
+	Goal goal_;											// goal of the running proof
+	unsigned long long nodes_;
+	unsigned long long collections_;
+};
+
+#endif /* PNSOLVER_H_ */
@@ -0,0 +1,179 @@
+/*
+ * PositionCache.cpp
+ *
+ * PositionCache class implementation.
+ * The PositionCache is a hash table of solved or deeply searched positions in a memory mapped file, shared by
+ * several engine processes without locks.
+ */
+
+#include "PositionCache.h"
+#include "Board.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if ATOMIC_LLONG_LOCK_FREE != 2
+#error "PositionCache needs lock-free 64 bit atomics to share them between processes"
+#endif
+
+namespace {
+
+const uint64_t kMagic = 0x5454544341434845ULL;		// "TTTCACHE", written last when the file is initialized
+const uint32_t kVersion = 1;
+const uint64_t kValid = 1ULL << 32;					// set in the data of every stored entry
+
+}
+
+struct PositionCache::Header {						// the first 64 bytes of the file
+	std::atomic<uint64_t> magic;					// kMagic once the file is initialized
+	uint32_t version;
+	uint32_t rows;									// board the positions were searched for
+	uint32_t cols;
+	uint32_t win_line;
+	uint64_t entries;								// number of slots following the header
+	uint32_t slot_size;
+	char reserved[28];
+};
+
+/*
+ * PositionCache constructor - no file is mapped yet, probe() misses and store() does nothing until open() is called
+ */
+PositionCache::PositionCache() : mapping_(NULL), mapping_size_(0), slots_(NULL), mask_(0) {
+}
+
+/*
+ * PositionCache destructor - unmaps the file (the file itself is kept for the next process)
+ */
+PositionCache::~PositionCache() {
+	if (mapping_ != NULL){
+		munmap(mapping_, mapping_size_);
+	}
+}
+
+/*
+ * open() - maps the cache file. A missing file (or one left unfinished by a process that died while creating it) is
+ * initialized with entries slots (rounded up to a power of 2). The file is checked and initialized under an exclusive
+ * flock(), so processes opening it at the same time wait for the one initializing it, and the lock of a process that
+ * died is released by the system.
+ * Throws std::runtime_error if the file cannot be created or mapped, or was created for another board.
+ */
+void PositionCache::open(const std::string& path, const uint64_t entries){
+	static_assert(sizeof(Header) == 64, "the header layout is part of the file format");
+	if (mapping_ != NULL){
+		throw std::runtime_error("POSITION CACHE - already open");
+	}
+
+	int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0666);
+	if (fd < 0){
+		throw std::runtime_error("POSITION CACHE - cannot open " + path + ": " + std::strerror(errno));
+	}
+	if (flock(fd, LOCK_EX) != 0){					// released by close(), also if the process dies
+		::close(fd);
+		throw std::runtime_error("POSITION CACHE - cannot lock " + path + ": " + std::strerror(errno));
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0){
+		::close(fd);
+		throw std::runtime_error("POSITION CACHE - cannot open " + path + ": " + std::strerror(errno));
+	}
+	bool create = true;								// new file or never published
+	if (file_stat.st_size >= static_cast<off_t>(sizeof(Header))){
+		mapping_size_ = file_stat.st_size;
+		mapping_ = mmap(NULL, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (mapping_ == MAP_FAILED || static_cast<Header*>(mapping_)->magic.load(std::memory_order_acquire) == kMagic){
+			create = false;
+		} else {									// the process creating the file died before publishing it
+			munmap(mapping_, mapping_size_);
+		}
+	}
+
+	if (create){
+		uint64_t slots = 1024;
+		while (slots < entries){
+			slots *= 2;
+		}
+		mapping_size_ = sizeof(Header) + slots*sizeof(Slot);
+		// truncating to 0 first fills the whole file with zeros - all slots empty
+		if (ftruncate(fd, 0) != 0 || ftruncate(fd, mapping_size_) != 0){
+			::close(fd);
+			throw std::runtime_error("POSITION CACHE - cannot resize " + path + ": " + std::strerror(errno));
+		}
+		mapping_ = mmap(NULL, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (mapping_ != MAP_FAILED){
+			Header* header = static_cast<Header*>(mapping_);
+			header->version = kVersion;
+			header->rows = Board::kRows;
+			header->cols = Board::kCols;
+			header->win_line = Board::kWinLine;
+			header->entries = slots;
+			header->slot_size = sizeof(Slot);
+			header->magic.store(kMagic, std::memory_order_release);
+		}
+	}
+	::close(fd);									// the mapping stays valid
+
+	if (mapping_ == MAP_FAILED){
+		mapping_ = NULL;
+		throw std::runtime_error("POSITION CACHE - cannot map " + path);
+	}
+	const Header* header = static_cast<const Header*>(mapping_);
+	if (header->version != kVersion || header->rows != static_cast<uint32_t>(Board::kRows)
+			|| header->cols != static_cast<uint32_t>(Board::kCols) || header->win_line != static_cast<uint32_t>(Board::kWinLine)
+			|| header->slot_size != sizeof(Slot) || (header->entries & (header->entries-1)) != 0
+			|| sizeof(Header) + header->entries*sizeof(Slot) > mapping_size_){
+		munmap(mapping_, mapping_size_);
+		mapping_ = NULL;
+		throw std::runtime_error("POSITION CACHE - " + path + " was created for another board or version");
+	}
+	slots_ = reinterpret_cast<Slot*>(static_cast<char*>(mapping_) + sizeof(Header));
+	mask_ = header->entries - 1;
+}
+
+/*
+ * probe() - looks the position with the (canonical) key up, returns false if it is not stored.
+ * Lock-free: an entry being written at the same time does not validate and is reported as missing.
+ */
+bool PositionCache::probe(const uint64_t key, CachedPosition& position) const{
+	if (slots_ == NULL){
+		return false;
+	}
+	const Slot& slot = slots_[key & mask_];
+	uint64_t data = slot.data.load(std::memory_order_relaxed);
+	uint64_t check = slot.check.load(std::memory_order_relaxed);
+	if ((check ^ data) != key || (data & kValid) == 0){
+		return false;
+	}
+	position.score = static_cast<int>(data & 0xFFFF) - 32768;
+	position.depth = static_cast<int>((data >> 16) & 0xFF);
+	position.bound = static_cast<int>((data >> 24) & 0xFF);
+	return true;
+}
+
+/*
+ * store() - stores the position with the (canonical) key, the entry of the same position searched deeper is kept.
+ * Lock-free: data and check are written with one atomic store each, a reader seeing only one of them gets a miss.
+ */
+void PositionCache::store(const uint64_t key, const CachedPosition& position){
+	if (slots_ == NULL){
+		return;
+	}
+	CachedPosition stored;
+	if (probe(key, stored) && stored.depth > position.depth){
+		return;
+	}
+	uint64_t data = kValid
+			| static_cast<uint64_t>((position.score + 32768) & 0xFFFF)
+			| static_cast<uint64_t>(position.depth & 0xFF) << 16
+			| static_cast<uint64_t>(position.bound & 0xFF) << 24;
+	Slot& slot = slots_[key & mask_];
+	slot.data.store(data, std::memory_order_relaxed);
+	slot.check.store(key ^ data, std::memory_order_relaxed);
+}
@@ -0,0 +1,57 @@
+/*
+ * PositionCache.h
+ *
+ * PositionCache class definition.
+ * The PositionCache is a hash table of solved or deeply searched positions in a memory mapped file. Several engine
+ * processes can map the same file: reads are lock-free, every entry is written with two atomic 64 bit stores and
+ * validated on read (the stored check word is key XOR data, a torn entry does not validate and reads as a miss).
+ * The file survives restarts, a new process starts with all results of the earlier ones.
+ * Positions are keyed by their canonical hash (Board::getCanonicalHash()), so rotated and mirrored positions share
+ * one entry. Scores are stored from the view of the player to move and relative to the position (see AiPlayer).
+ */
+
+#ifndef POSITIONCACHE_H_
+#define POSITIONCACHE_H_
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+struct CachedPosition {								// Position read from the cache
+	int score;										// score for the player to move, relative to the position
+	int depth;										// look ahead of the search (kSolved = exact game value)
+	int bound;										// SearchContext::Bound of the score
+};
+
+class PositionCache {
+public:
+	static const int kSolved = 255;					// depth of positions with a proven game value
+	static const uint64_t kDefaultEntries = 1 << 22;	// entries of a new cache file (64 MB)
+
+	PositionCache();								// Constructor - no file mapped yet
+	virtual ~PositionCache();						// Destructor - unmaps the file
+
+	//maps the cache file, creates it with entries slots (rounded up to a power of 2) if it does not exist (or was left
+	//unfinished by a process that died while creating it).
+	//Throws std::runtime_error if the file cannot be mapped or was created for another board size.
+	void open(const std::string& path, const uint64_t entries = kDefaultEntries);
+
+	bool probe(const uint64_t key, CachedPosition& position) const;	// find a position, lock-free
+	void store(const uint64_t key, const CachedPosition& position);	// store a position, lock-free
+private:
+	PositionCache(const PositionCache&);			// not copyable
+	PositionCache& operator=(const PositionCache&);
+
+	struct Header;									// layout of the beginning of the file
+	struct Slot {									// one entry of the table
+		std::atomic<uint64_t> check;				// key XOR data
+		std::atomic<uint64_t> data;					// packed score, depth and bound
+	};
+
+	void* mapping_;									// the mapped file
+	size_t mapping_size_;
+	Slot* slots_;
+	uint64_t mask_;									// number of slots - 1
+};
+
+#endif /* POSITIONCACHE_H_ */
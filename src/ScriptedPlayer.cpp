@@ -0,0 +1,183 @@
+/*
+ * ScriptedPlayer.cpp
+ *
+ * MoveScript and ScriptedPlayer class implementations.
+ * A MoveScript holds games read from a file or pipe, one game per line, moves written as column,row.
+ * The ScriptedPlayer plays the moves of a MoveScript game instead of asking the user.
+ */
+
+#include "ScriptedPlayer.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+/*
+ * MoveScript constructor - creates an empty script
+ */
+MoveScript::MoveScript() {
+}
+
+/*
+ * read() - reads all games (one per line) from in and validates them before any game is played.
+ * Every move must be inside of the board and every field may be used once per game. If all_moves is true the
+ * games are replayed on a board: every move must be legal, no move may follow a win and the last move has to end
+ * the game. Moves after a dead draw (no win line can be completed anymore, see Board::evaluateBoard()) are accepted,
+ * games recorded until the board is full stay valid - the replay ends at the draw. All invalid lines are reported
+ * together in one std::invalid_argument exception.
+ */
+void MoveScript::read(std::istream& in, const bool all_moves){
+	const int kMaxReported = 20;			// number of invalid lines listed in the exception
+	std::ostringstream errors;
+	int error_count = 0;
+	std::string line;
+	int line_number = 0;
+	Board board;
+
+	while (std::getline(in, line)){
+		line_number++;
+		std::istringstream tokens(line);
+		std::string token;
+		std::vector<Move> moves;
+		std::string error;
+
+		while (error.empty() && tokens >> token){
+			if (moves.empty() && token[0] == '#'){		// comment line
+				break;
+			}
+			Move move(0,0);
+			if (!parseMove(token, move)){
+				error = "invalid move '" + token + "', expected column,row";
+			} else {
+				moves.push_back(move);
+			}
+		}
+
+		if (error.empty() && !moves.empty()){
+			board.resetBoard();
+			char mark = 'X';
+			for (int i=0,max=moves.size(); i<max && error.empty(); i++){
+				if (!board.validMove(moves[i].row, moves[i].col)){
+					error = "move " + std::to_string(i+1) + " is outside of the board or on an occupied field";
+				} else if (all_moves && board.evaluateBoard() != Board::PLAY && board.evaluateBoard() != Board::DRAW){
+					error = "move " + std::to_string(i+1) + " is played after the end of the game";
+				} else {
+					board.makeMove(moves[i].row, moves[i].col, mark);
+					if (all_moves){
+						mark = (mark == 'X') ? 'O' : 'X';
+					}
+				}
+			}
+			if (error.empty() && all_moves && board.evaluateBoard() == Board::PLAY){
+				error = "the game is not finished";
+			}
+		}
+
+		if (!error.empty()){
+			error_count++;
+			if (error_count <= kMaxReported){
+				errors << "\nline " << line_number << ": " << error;
+			}
+		} else if (!moves.empty()){
+			games_.push_back(moves);
+			lines_.push_back(line_number);
+		}
+	}
+
+	if (error_count > 0){
+		std::ostringstream message;
+		message << "INVALID SCRIPT - " << error_count << " invalid line(s)" << errors.str();
+		if (error_count > kMaxReported){
+			message << "\n...";
+		}
+		throw std::invalid_argument(message.str());
+	}
+}
+
+/*
+ * parseMove() - parses a column,row token into move, returns false if the token is not two numbers separated by a comma
+ */
+bool MoveScript::parseMove(const std::string& token, Move& move){
+	const char* text = token.c_str();
+	char* end = NULL;
+	long col = std::strtol(text, &end, 10);
+	if (end == text || *end != ','){
+		return false;
+	}
+	text = end + 1;
+	long row = std::strtol(text, &end, 10);
+	if (end == text || *end != '\0'){
+		return false;
+	}
+	move.row = static_cast<int>(row);
+	move.col = static_cast<int>(col);
+	return true;
+}
+
+/*
+ * getGameCount() - returns the number of games in the script
+ */
+int MoveScript::getGameCount() const{
+	return games_.size();
+}
+
+/*
+ * getGame() - returns the moves of a game
+ */
+const std::vector<Move>& MoveScript::getGame(const int game) const{
+	return games_[game];
+}
+
+/*
+ * getLine() - returns the line number of a game in the script (for error messages)
+ */
+int MoveScript::getLine(const int game) const{
+	return lines_[game];
+}
+
+/*
+ * ScriptedPlayer constructor, calls the Player constructor.
+ * Constructor argument is the mark of the player to be created.
+ */
+ScriptedPlayer::ScriptedPlayer(const char mark) : Player(mark), moves_(NULL), next_(NULL) {
+}
+
+/*
+ * ScriptedPlayer destructor
+ */
+ScriptedPlayer::~ScriptedPlayer() {
+}
+
+/*
+ * setMoves() - sets the moves to be played. next points to the position of the next move and is advanced by
+ * every move, so two players sharing next play one list of moves in turns.
+ */
+void ScriptedPlayer::setMoves(const std::vector<Move>* moves, int* next){
+	moves_ = moves;
+	next_ = next;
+}
+
+/*
+ * performMove() - places the next move of the script on the board, the TUI is not used.
+ * Throws std::invalid_argument if the script has no move left or the move is not valid on the board
+ * (possible when playing against the AiPlayer, which may take the field first).
+ */
+Move ScriptedPlayer::performMove(Board& board, TUI& /*ui*/){
+	if (moves_ == NULL || *next_ >= static_cast<int>(moves_->size())){
+		throw std::invalid_argument("INVALID SCRIPT - no move left for the game");
+	}
+	Move move = (*moves_)[*next_];
+	(*next_)++;
+	if (!board.validMove(move.row, move.col)){
+		throw std::invalid_argument("INVALID MOVE");
+	}
+	board.makeMove(move.row, move.col, getMark());
+	return move;
+}
+
+/*
+ * isInteractive() - the ScriptedPlayer reads its moves from the script
+ */
+bool ScriptedPlayer::isInteractive() const{
+	return false;
+}
@@ -0,0 +1,56 @@
+/*
+ * ScriptedPlayer.h
+ *
+ * MoveScript and ScriptedPlayer class definitions.
+ * A MoveScript holds games read from a file or pipe, one game per line. A move is written as column,row
+ * (same order as the TUI asks for it), moves are separated by blanks, e.g. "2,2 1,1 3,1".
+ * Empty lines and lines starting with # are ignored.
+ * The ScriptedPlayer plays the moves of a MoveScript game instead of asking the user, so games can be played
+ * back to back without any prompts (load tests, replays of recorded games).
+ */
+
+#ifndef SCRIPTEDPLAYER_H_
+#define SCRIPTEDPLAYER_H_
+
+#include "Player.h"
+#include "Board.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+class MoveScript {
+public:
+	MoveScript();										//Constructor - empty script
+
+	//reads all games from in and validates them in one pass. all_moves = true if the games list the moves of both
+	//players (replay), then they are also replayed on a board to check that every move is legal and the last move
+	//ends the game (moves after a dead draw are allowed). Throws std::invalid_argument listing every invalid line.
+	void read(std::istream& in, const bool all_moves);
+
+	int getGameCount() const;							//number of games in the script
+	const std::vector<Move>& getGame(const int game) const;	//moves of a game
+	int getLine(const int game) const;					//line number of a game in the script
+private:
+	static bool parseMove(const std::string& token, Move& move);	//parse one column,row token
+	std::vector< std::vector<Move> > games_;
+	std::vector<int> lines_;
+};
+
+class ScriptedPlayer: public Player {
+public:
+	ScriptedPlayer(const char mark);					//Constructor - taking the mark of the player as input
+	virtual ~ScriptedPlayer();							//Destructor
+
+	//plays the moves from position next of moves, next is advanced by every move. Players sharing next
+	//play one list of moves in turns (replay).
+	void setMoves(const std::vector<Move>* moves, int* next);
+
+	Move performMove(Board& board, TUI& ui);			//Places the next move of the script on the board. Overrides Player::performMove()
+	bool isInteractive() const;							//The ScriptedPlayer does not need the TUI. Overrides Player::isInteractive()
+private:
+	const std::vector<Move>* moves_;					//moves of the current game
+	int* next_;											//position of the next move in moves_
+};
+
+#endif /* SCRIPTEDPLAYER_H_ */
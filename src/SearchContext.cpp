@@ -0,0 +1,214 @@
+/*
+ * SearchContext.cpp
+ *
+ * SearchContext - class implementation.
+ * The SearchContext class holds the state of the AiPlayer search which is worth keeping between moves:
+ * the transposition table, the killer and history tables used for move ordering, preallocated move
+ * buffers for every ply of the search, the principal variations and the search statistics.
+ */
+
+#include "SearchContext.h"
+
+/*
+ * SearchContext() - Constructor
+ * allocates the transposition table and the move buffers once, so the search itself never allocates.
+ */
+SearchContext::SearchContext() : table_(kTableSize), move_buffers_(kMaxPly), stop_(NULL), has_deadline_(false), stopped_(false) {
+	for (int i=0; i<kMaxPly; i++){
+		move_buffers_[i].reserve(Board::kRows*Board::kCols);
+	}
+	reset();
+}
+
+/*
+ * ~SearchContext() - Destructor
+ */
+SearchContext::~SearchContext() {
+}
+
+/*
+ * reset() - forgets everything learned so far (transposition table, killers, history, statistics).
+ * Called between games.
+ */
+void SearchContext::reset(){
+	for (int i=0; i<kTableSize; i++){
+		table_[i] = TableEntry();						// kNoBound - unused
+	}
+	for (int i=0; i<Board::kRows; i++){
+		for (int j=0; j<Board::kCols; j++){
+			history_[i][j] = 0;
+		}
+	}
+	newSearch();
+}
+
+/*
+ * newSearch() - prepares the context for the next move. The transposition table and the history are kept,
+ * killer moves (which are tied to a ply of the previous search) and statistics are cleared.
+ */
+void SearchContext::newSearch(){
+	for (int i=0; i<kMaxPly; i++){
+		for (int k=0; k<kKillers; k++){
+			killers_[i][k][0] = 0;
+			killers_[i][k][1] = 0;
+		}
+		pv_length_[i] = 0;
+	}
+	statistics_ = SearchStatistics();
+	stop_ = NULL;
+	has_deadline_ = false;
+	stopped_ = false;
+}
+
+/*
+ * beginSearch() - starts the clock of the time limit and watches the stop flag of the limits
+ */
+void SearchContext::beginSearch(const SearchLimits& limits){
+	stop_ = limits.stop;
+	has_deadline_ = limits.max_millis > 0;
+	if (has_deadline_){
+		deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.max_millis);
+	}
+	stopped_ = false;
+}
+
+/*
+ * stopped() - returns true once the stop flag is set or the time limit is over, the search has to return immediately.
+ * The clock is read only every 1024 nodes to keep the check cheap.
+ */
+bool SearchContext::stopped(){
+	if (stopped_){
+		return true;
+	}
+	if (stop_ != NULL && stop_->load(std::memory_order_relaxed)){
+		stopped_ = true;
+	} else if (has_deadline_ && (statistics_.nodes & 1023) == 0 && std::chrono::steady_clock::now() >= deadline_){
+		stopped_ = true;
+	}
+	return stopped_;
+}
+
+/*
+ * probe() - returns the transposition table entry of the position with the hash key, NULL if the position is not stored
+ */
+const TableEntry* SearchContext::probe(const uint64_t key) const{
+	const TableEntry& entry = table_[key & (kTableSize-1)];
+	if (entry.key == key && entry.bound != kNoBound){
+		return &entry;
+	}
+	return NULL;
+}
+
+/*
+ * store() - stores the search result of a position in the transposition table.
+ * A stored position is only replaced by the same position searched at least as deep, other positions always replace it.
+ * Unused entries are told by their bound, every key is valid (the empty board hashes to 0).
+ */
+void SearchContext::store(const uint64_t key, const int score, const int depth, const Bound bound, const int row, const int col){
+	TableEntry& entry = table_[key & (kTableSize-1)];
+	if (entry.bound != kNoBound && entry.key == key && entry.depth > depth){
+		return;
+	}
+	entry.key = key;
+	entry.score = score;
+	entry.depth = static_cast<signed char>(depth);
+	entry.bound = static_cast<unsigned char>(bound);
+	entry.row = static_cast<signed char>(row);
+	entry.col = static_cast<signed char>(col);
+}
+
+/*
+ * moveBuffer() - returns the preallocated move list of the ply
+ */
+std::vector<AiMove>& SearchContext::moveBuffer(const int ply){
+	return move_buffers_[ply];
+}
+
+/*
+ * orderMoves() - sorts the moves so the most promising ones are searched first:
+ * the best move from the transposition table, then the killer moves of the ply, then by history.
+ * The score field of the moves is used as sort key, it is overwritten by the search afterwards.
+ */
+void SearchContext::orderMoves(std::vector<AiMove>& moves, const int ply, const int best_row, const int best_col) const{
+	for (int i=0,max=moves.size(); i<max; i++){
+		AiMove& move = moves[i];
+		if (move.row == best_row && move.col == best_col){
+			move.score = 1 << 30;
+		} else if (move.row == killers_[ply][0][0] && move.col == killers_[ply][0][1]){
+			move.score = 1 << 29;
+		} else if (move.row == killers_[ply][1][0] && move.col == killers_[ply][1][1]){
+			move.score = 1 << 28;
+		} else {
+			move.score = history_[move.row-1][move.col-1];
+		}
+	}
+	// insertion sort - the lists are short and it keeps equal moves in board order
+	for (int i=1,max=moves.size(); i<max; i++){
+		AiMove move = moves[i];
+		int j = i - 1;
+		while (j >= 0 && moves[j].score < move.score){
+			moves[j+1] = moves[j];
+			j--;
+		}
+		moves[j+1] = move;
+	}
+}
+
+/*
+ * addCutoff() - remembers a move which caused a cut-off as killer move of the ply and in the history table
+ */
+void SearchContext::addCutoff(const AiMove& move, const int ply, const int look_ahead){
+	if (move.row != killers_[ply][0][0] || move.col != killers_[ply][0][1]){
+		killers_[ply][1][0] = killers_[ply][0][0];
+		killers_[ply][1][1] = killers_[ply][0][1];
+		killers_[ply][0][0] = move.row;
+		killers_[ply][0][1] = move.col;
+	}
+	history_[move.row-1][move.col-1] += look_ahead*look_ahead;
+	if (history_[move.row-1][move.col-1] >= (1 << 27)){		// keep the history below the killer keys
+		for (int i=0; i<Board::kRows; i++){
+			for (int j=0; j<Board::kCols; j++){
+				history_[i][j] /= 2;
+			}
+		}
+	}
+}
+
+/*
+ * clearPv() - called when a node of the ply is entered, its principal variation is empty until a move improves
+ * alpha (beta)
+ */
+void SearchContext::clearPv(const int ply){
+	pv_length_[ply] = 0;
+}
+
+/*
+ * updatePv() - triangular PV table: the principal variation of the ply becomes the move followed by the principal
+ * variation of the next ply (the one the move has just been searched with)
+ */
+void SearchContext::updatePv(const int ply, const AiMove& move){
+	pv_[ply][0][0] = move.row;
+	pv_[ply][0][1] = move.col;
+	int length = (ply+1 < kMaxPly) ? pv_length_[ply+1] : 0;
+	for (int i=0; i<length; i++){
+		pv_[ply][i+1][0] = pv_[ply+1][i][0];
+		pv_[ply][i+1][1] = pv_[ply+1][i][1];
+	}
+	pv_length_[ply] = length + 1;
+}
+
+/*
+ * appendPv() - appends the principal variation of the last node searched on the ply to pv
+ */
+void SearchContext::appendPv(const int ply, std::vector<Move>& pv) const{
+	for (int i=0; i<pv_length_[ply]; i++){
+		pv.push_back(Move(pv_[ply][i][0], pv_[ply][i][1]));
+	}
+}
+
+/*
+ * statistics() - returns the counters of the current/last search
+ */
+SearchStatistics& SearchContext::statistics(){
+	return statistics_;
+}
@@ -0,0 +1,119 @@
+/*
+ * SearchContext.h
+ *
+ * SearchContext - class definition.
+ * The SearchContext class holds the state of the AiPlayer search which is worth keeping between moves:
+ * the transposition table, the killer and history tables used for move ordering, preallocated move
+ * buffers for every ply of the search, the principal variations (triangular PV table) and the search statistics.
+ * Every AiPlayer owns one SearchContext. It survives between the moves of a game and is reset between games.
+ */
+
+#ifndef SEARCHCONTEXT_H_
+#define SEARCHCONTEXT_H_
+
+#include "Board.h"
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdint.h>
+
+struct AiMove {											// Create a struct to store/return the AiMoves
+	AiMove(int scr) : row(0), col(0),score(scr){};				// constructor with score
+	AiMove(int row, int col) : row(row), col(col), score(0){};	// constructor with coordinates, w/o score
+	int row;
+	int col;
+	int score;
+};
+
+struct PvLine {											// Root move of an analysis with its principal variation
+	PvLine(const AiMove& move) : move(move){};
+	AiMove move;										// the root move and its exact score
+	std::vector<Move> pv;								// expected moves of both players, starting with the root move
+};
+
+typedef std::function<void(const AiMove& best_move, const int look_ahead)> SearchProgress;	// progress report of a search
+
+struct SearchLimits {									// Limits of a single search
+	SearchLimits(int look_ahead) : look_ahead(look_ahead), max_millis(0), stop(NULL){};
+	int look_ahead;										// deepest look ahead to search
+	long max_millis;									// time limit in milliseconds (0 = no limit)
+	const std::atomic<bool>* stop;						// the search stops as soon as this flag is set (NULL = never)
+	SearchProgress progress;							// called with the best move after every completed look ahead (optional)
+};
+
+struct SearchOptions {									// Selectivity of the AiPlayer search
+	SearchOptions() : late_move_reductions(Board::kRows*Board::kCols > 16), reduction_min_look_ahead(3),
+			reduction_min_move(3), futility_pruning(true){};
+	bool late_move_reductions;							// search late moves one ply shallower with a null window (not exact,
+														// on by default for boards larger than 4x4 only)
+	int reduction_min_look_ahead;						// reduce only at nodes with at least this look ahead
+	int reduction_min_move;								// the first moves of a node are never reduced
+	bool futility_pruning;								// resolve the last two plies from the win line counters (exact)
+};
+
+struct TableEntry {										// Entry of the transposition table
+	uint64_t key;										// full hash of the position
+	int score;											// score relative to the position (see AiPlayer::toTableScore())
+	signed char depth;									// look ahead the score was searched with
+	unsigned char bound;								// SearchContext::Bound of the score (kNoBound = unused entry)
+	signed char row;									// best move found in the position
+	signed char col;
+};
+
+struct SearchStatistics {								// Counters of the last search
+	SearchStatistics() : nodes(0), table_hits(0), table_cutoffs(0), beta_cutoffs(0), futility_cutoffs(0),
+			reductions(0), re_searches(0), cache_cutoffs(0){};
+	unsigned long long nodes;							// positions visited
+	unsigned long long table_hits;						// positions found in the transposition table
+	unsigned long long table_cutoffs;					// positions resolved by the transposition table
+	unsigned long long beta_cutoffs;					// alpha >= beta cut-offs
+	unsigned long long futility_cutoffs;				// positions resolved by futility pruning
+	unsigned long long reductions;						// moves searched with reduced look ahead
+	unsigned long long re_searches;						// reduced moves searched again with full look ahead
+	unsigned long long cache_cutoffs;					// positions resolved by the shared position cache
+};
+
+class SearchContext {
+public:
+	enum Bound {kNoBound, kExact, kLower, kUpper};		// how the score of a TableEntry relates to the real score
+	static const int kTableSize = 1 << 16;				// number of transposition table entries (power of 2)
+	static const int kMaxPly = Board::kRows*Board::kCols + 1;	// deepest possible ply of a search
+	static const int kKillers = 2;						// killer moves remembered per ply
+
+	SearchContext();									// Constructor - allocates all tables
+	virtual ~SearchContext();							// Destructor
+
+	void reset();										// forget everything - called between games
+	void newSearch();									// prepare for the next move, keeps the tables
+	void beginSearch(const SearchLimits& limits);		// start the clock and watch the stop flag of the limits
+	bool stopped();										// has the search been cancelled or run out of time?
+
+	const TableEntry* probe(const uint64_t key) const;	// find a position in the transposition table or NULL
+	void store(const uint64_t key, const int score, const int depth, const Bound bound, const int row, const int col);
+
+	std::vector<AiMove>& moveBuffer(const int ply);		// preallocated move list for a ply
+	void orderMoves(std::vector<AiMove>& moves, const int ply, const int best_row, const int best_col) const;
+	void addCutoff(const AiMove& move, const int ply, const int look_ahead);	// update killer and history tables
+
+	void clearPv(const int ply);						// no principal variation found on the ply yet
+	void updatePv(const int ply, const AiMove& move);	// move is the new best move of the ply, its PV follows from ply+1
+	void appendPv(const int ply, std::vector<Move>& pv) const;	// appends the principal variation of the ply to pv
+
+	SearchStatistics& statistics();						// counters of the current/last search
+private:
+	std::vector<TableEntry> table_;						// transposition table, indexed by key & (kTableSize-1)
+	std::vector< std::vector<AiMove> > move_buffers_;	// one move list per ply
+	int killers_[kMaxPly][kKillers][2];					// [row, col] of moves which caused a cut-off on the ply
+	int history_[Board::kRows][Board::kCols];			// cut-off history of every field
+	int pv_[kMaxPly][kMaxPly][2];						// [row, col] of the principal variation from every ply
+	int pv_length_[kMaxPly];							// length of the principal variation from every ply
+	SearchStatistics statistics_;
+	const std::atomic<bool>* stop_;						// stop flag of the running search
+	std::chrono::steady_clock::time_point deadline_;	// end of the time limit of the running search
+	bool has_deadline_;
+	bool stopped_;
+};
+
+#endif /* SEARCHCONTEXT_H_ */
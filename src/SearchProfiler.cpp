@@ -0,0 +1,184 @@
+/*
+ * SearchProfiler.cpp
+ *
+ * SearchProfiler class implementation.
+ * The SearchProfiler attributes the hardware counters of a move to the phases of the search and writes the
+ * optional Chrome trace.
+ */
+
+#include "SearchProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+
+/*
+ * SearchProfiler constructor - opens the counters of the calling thread, the profiler keeps working without them
+ * (nodes and time only) and says so once.
+ */
+SearchProfiler::SearchProfiler() : available_(false), mark_(' '), depth_(0), trace_plies_(kDefaultTracePlies),
+		trace_first_event_(true) {
+	available_ = counters_.open();
+	if (!available_){
+		std::fprintf(stderr, "profile: hardware counters not available (%s), reporting nodes and time only\n",
+				counters_.getError().c_str());
+	} else if (!counters_.getError().empty()){
+		std::fprintf(stderr, "profile: some hardware counters not available (%s)\n", counters_.getError().c_str());
+	}
+	for (int i=0; i<kPhases; i++){
+		phase_calls_[i] = 0;
+	}
+}
+
+/*
+ * SearchProfiler destructor - closes the JSON array of the trace
+ */
+SearchProfiler::~SearchProfiler() {
+	if (trace_.is_open()){
+		trace_ << "\n]\n";
+	}
+}
+
+/*
+ * openTrace() - starts writing the Chrome trace to path: a span for every move and for the phases of the nodes
+ * of the first trace_plies plies. Returns false if the file cannot be created.
+ */
+bool SearchProfiler::openTrace(const std::string& path, const int trace_plies){
+	trace_.open(path.c_str(), std::ios::out | std::ios::trunc);
+	if (!trace_){
+		return false;
+	}
+	trace_plies_ = trace_plies;
+	trace_first_event_ = true;
+	trace_start_ = std::chrono::steady_clock::now();
+	trace_ << std::fixed << std::setprecision(3) << "[";
+	return true;
+}
+
+/*
+ * countersAvailable() - returns false if no hardware counter could be opened
+ */
+bool SearchProfiler::countersAvailable() const{
+	return available_;
+}
+
+/*
+ * beginMove() - starts profiling a move of the player with mark, the counts of the previous move are cleared
+ */
+void SearchProfiler::beginMove(const char mark){
+	mark_ = mark;
+	for (int i=0; i<kPhases; i++){
+		phase_counts_[i] = PerfSample();
+		phase_calls_[i] = 0;
+	}
+	depth_ = 0;
+	traceEvent("move", 'B');
+	move_start_time_ = std::chrono::steady_clock::now();
+	counters_.read(move_start_);
+	last_sample_ = move_start_;
+}
+
+/*
+ * endMove() - ends the move and reports it to stderr: the totals of the move and the share of every phase
+ */
+void SearchProfiler::endMove(const int row, const int col, const unsigned long long nodes){
+	PerfSample move_end;
+	counters_.read(move_end);
+	double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - move_start_time_).count();
+	traceEvent("move", 'E');
+	PerfSample total = move_end - move_start_;
+	const double per_node = nodes > 0 ? 1.0 / nodes : 0.0;
+
+	std::fprintf(stderr, "profile: %c move %d,%d  nodes %llu  time %.3f ms  nodes/s %.0f\n",
+			mark_, col, row, nodes, millis, millis > 0 ? nodes / millis * 1000.0 : 0.0);
+	if (!available_){
+		return;
+	}
+	std::fprintf(stderr, "profile:   cycles %llu  instructions %llu  IPC %.2f  cycles/node %.1f"
+			"  cache misses/node %.3f  branch misses/node %.3f\n",
+			static_cast<unsigned long long>(total.cycles), static_cast<unsigned long long>(total.instructions),
+			total.cycles > 0 ? static_cast<double>(total.instructions) / total.cycles : 0.0,
+			total.cycles * per_node, total.cache_misses * per_node, total.branch_misses * per_node);
+	for (int i=0; i<kPhases; i++){
+		const PerfSample& counts = phase_counts_[i];
+		std::fprintf(stderr, "profile:   %-16s calls %-9llu cycles %5.1f%%  IPC %.2f  cache misses %llu"
+				"  branch misses %llu\n",
+				phaseName(static_cast<Phase>(i)), phase_calls_[i],
+				total.cycles > 0 ? 100.0 * counts.cycles / total.cycles : 0.0,
+				counts.cycles > 0 ? static_cast<double>(counts.instructions) / counts.cycles : 0.0,
+				static_cast<unsigned long long>(counts.cache_misses),
+				static_cast<unsigned long long>(counts.branch_misses));
+	}
+}
+
+/*
+ * enter() - the phase starts at ply of the search, the counts so far belong to the enclosing phase
+ */
+void SearchProfiler::enter(const Phase phase, const int ply){
+	account();
+	if (depth_ >= kMaxDepth){							// deeper than any search - counted in the enclosing phase
+		depth_++;
+		return;
+	}
+	stack_[depth_] = phase;
+	traced_[depth_] = trace_.is_open() && ply < trace_plies_;
+	if (traced_[depth_]){
+		traceEvent(phaseName(phase), 'B');
+	}
+	phase_calls_[phase]++;
+	depth_++;
+}
+
+/*
+ * leave() - the current phase ends, its counts are added to it
+ */
+void SearchProfiler::leave(){
+	account();
+	depth_--;
+	if (depth_ < kMaxDepth && depth_ >= 0 && traced_[depth_]){
+		traceEvent(phaseName(stack_[depth_]), 'E');
+	}
+}
+
+/*
+ * account() - reads the counters and adds the counts since the last read to the running phase
+ * (to the recursion outside of any phase)
+ */
+void SearchProfiler::account(){
+	if (!available_){
+		return;
+	}
+	PerfSample sample;
+	counters_.read(sample);
+	Phase phase = (depth_ > 0) ? stack_[std::min(depth_, static_cast<int>(kMaxDepth)) - 1] : kRecursion;
+	phase_counts_[phase] += sample - last_sample_;
+	last_sample_ = sample;
+}
+
+/*
+ * traceEvent() - writes a Chrome trace event, type B begins and type E ends a span
+ */
+void SearchProfiler::traceEvent(const char* name, const char type){
+	if (!trace_.is_open()){
+		return;
+	}
+	double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - trace_start_).count();
+	trace_ << (trace_first_event_ ? "\n" : ",\n")
+		   << "{\"name\":\"" << name << "\",\"cat\":\"search\",\"ph\":\"" << type << "\",\"ts\":" << micros
+		   << ",\"pid\":1,\"tid\":" << (mark_ == 'O' ? 2 : 1) << "}";
+	trace_first_event_ = false;
+}
+
+/*
+ * phaseName() - returns the name of a phase for the report and the trace
+ */
+const char* SearchProfiler::phaseName(const Phase phase){
+	switch (phase){
+	case kMoveGeneration:
+		return "move generation";
+	case kEvaluation:
+		return "evaluation";
+	default:
+		return "recursion";
+	}
+}
@@ -0,0 +1,85 @@
+/*
+ * SearchProfiler.h
+ *
+ * SearchProfiler class definition.
+ * The SearchProfiler is the opt-in profiling mode of the AiPlayer search. It splits the hardware counters
+ * (PerfCounters) of every move into the phases of the search - move generation, evaluation and the recursion
+ * itself (everything else a node does) - and reports them per move to stderr: cycles, instructions, IPC and
+ * the cache and branch misses per node. That shows whether a slower search visits more nodes (algorithmic) or
+ * spends more cycles per node (memory bound, mispredicted).
+ * Optionally the phases are written as Chrome trace JSON (chrome://tracing, Perfetto) - nodes of the first
+ * plies only, deeper nodes are counted in their ancestors' spans to keep the file small.
+ * Reading the counters costs a system call per phase, profiled searches are considerably slower. A profiler
+ * counts the thread it is used on, every thread needs its own.
+ */
+
+#ifndef SEARCHPROFILER_H_
+#define SEARCHPROFILER_H_
+
+#include "PerfCounters.h"
+
+#include <chrono>
+#include <fstream>
+#include <string>
+
+class SearchProfiler {
+public:
+	enum Phase {kRecursion, kMoveGeneration, kEvaluation, kPhases};	// phases of the search
+	static const int kDefaultTracePlies = 3;			// plies of the search written to the trace
+	static const int kMaxDepth = 128;					// deepest nesting of phases
+
+	class Scope {										// Counts a block of the search as phase (no-op without profiler)
+	public:
+		Scope(SearchProfiler* profiler, const Phase phase, const int ply) : profiler_(profiler) {
+			if (profiler_ != NULL){
+				profiler_->enter(phase, ply);
+			}
+		}
+		~Scope() {
+			if (profiler_ != NULL){
+				profiler_->leave();
+			}
+		}
+	private:
+		SearchProfiler* profiler_;
+	};
+
+	SearchProfiler();									// Constructor - opens the counters of the calling thread
+	virtual ~SearchProfiler();							// Destructor - completes the trace file
+
+	//writes the phases of the first trace_plies plies as Chrome trace JSON to path, false if it cannot be created
+	bool openTrace(const std::string& path, const int trace_plies = kDefaultTracePlies);
+	bool countersAvailable() const;						// false if the hardware counters could not be opened
+
+	void beginMove(const char mark);					// starts profiling a move of the player with mark
+	void endMove(const int row, const int col, const unsigned long long nodes);	// reports the move to stderr
+	void enter(const Phase phase, const int ply);		// a phase starts (nested in the current one)
+	void leave();										// the current phase ends
+private:
+	SearchProfiler(const SearchProfiler&);				// not copyable
+	SearchProfiler& operator=(const SearchProfiler&);
+
+	void account();										// adds the counts since the last read to the current phase
+	void traceEvent(const char* name, const char type);	// writes a begin (B) or end (E) event to the trace
+	static const char* phaseName(const Phase phase);
+
+	PerfCounters counters_;
+	bool available_;
+	PerfSample last_sample_;							// counters at the last phase change
+	PerfSample phase_counts_[kPhases];					// counts of the current move per phase (exclusive)
+	unsigned long long phase_calls_[kPhases];
+	PerfSample move_start_;
+	std::chrono::steady_clock::time_point move_start_time_;
+	char mark_;
+
+	Phase stack_[kMaxDepth];							// nested phases, the last one is running
+	int traced_[kMaxDepth];								// was the phase written to the trace
+	int depth_;
+
+	std::ofstream trace_;
+	int trace_plies_;
+	bool trace_first_event_;
+	std::chrono::steady_clock::time_point trace_start_;
+};
+
+#endif /* SEARCHPROFILER_H_ */
@@ -0,0 +1,250 @@
+/*
+ * SessionStore.cpp
+ *
+ * SessionStore and SessionWorker class implementations.
+ * The SessionStore keeps the compact state of many concurrent games in a pool, the SessionWorker plays their moves.
+ */
+
+#include "SessionStore.h"
+
+#include <stdexcept>
+#include <string>
+
+/*
+ * SessionStore constructor - reserves space for sessions, more are added as needed
+ */
+SessionStore::SessionStore(const size_t sessions) : open_sessions_(0) {
+	sessions_.reserve(sessions);
+}
+
+/*
+ * SessionStore destructor
+ */
+SessionStore::~SessionStore() {
+}
+
+/*
+ * addConfig() - registers a config shared by the sessions opened with its index. Throws std::length_error if there
+ * are too many configs.
+ */
+int SessionStore::addConfig(const SessionConfig& config){
+	if (configs_.size() > UINT16_MAX){
+		throw std::length_error("SESSION STORE - too many configs");
+	}
+	configs_.push_back(config);
+	return configs_.size() - 1;
+}
+
+/*
+ * getConfig() - returns the config with the index (see addConfig())
+ */
+const SessionConfig& SessionStore::getConfig(const int config) const{
+	return configs_.at(config);
+}
+
+/*
+ * getConfigCount() - returns the number of registered configs
+ */
+int SessionStore::getConfigCount() const{
+	return configs_.size();
+}
+
+/*
+ * open() - opens a new game with the config in a closed slot or a new one at the end of the pool.
+ * Throws std::invalid_argument if the config is not registered.
+ */
+SessionId SessionStore::open(const int config){
+	if (config < 0 || config >= static_cast<int>(configs_.size())){
+		throw std::invalid_argument("SESSION STORE - unknown config " + std::to_string(config));
+	}
+	uint32_t slot;
+	if (!free_.empty()){
+		slot = free_.back();
+		free_.pop_back();
+	} else {
+		slot = sessions_.size();
+		sessions_.push_back(Session());
+		sessions_[slot].generation = 0;
+	}
+	Session& session = sessions_[slot];
+	session.state.clear();
+	session.generation++;
+	if (session.generation == 0){						// wrapped around - 0 would make kNoSession valid
+		session.generation = 1;
+	}
+	session.config = static_cast<uint16_t>(config);
+	session.open = true;
+	open_sessions_++;
+	return (static_cast<SessionId>(session.generation) << 32) | slot;
+}
+
+/*
+ * close() - ends the session, its slot is reused by a later open(). Unknown sessions are ignored.
+ */
+void SessionStore::close(const SessionId id){
+	Session* session = find(id);
+	if (session == NULL){
+		return;
+	}
+	session->open = false;
+	free_.push_back(static_cast<uint32_t>(id));
+	open_sessions_--;
+}
+
+/*
+ * isOpen() - returns true if the session is open (closed sessions and reused slots return false)
+ */
+bool SessionStore::isOpen(const SessionId id) const{
+	return find(id) != NULL;
+}
+
+/*
+ * load() - copies the state of the session to state, returns false if the session is not open
+ */
+bool SessionStore::load(const SessionId id, GameState& state) const{
+	const Session* session = find(id);
+	if (session == NULL){
+		return false;
+	}
+	state = session->state;
+	return true;
+}
+
+/*
+ * save() - replaces the state of the session (restore of a snapshot), returns false if the session is not open
+ */
+bool SessionStore::save(const SessionId id, const GameState& state){
+	Session* session = find(id);
+	if (session == NULL){
+		return false;
+	}
+	session->state = state;
+	return true;
+}
+
+/*
+ * getConfigIndex() - returns the index of the config of the session, -1 if the session is not open
+ */
+int SessionStore::getConfigIndex(const SessionId id) const{
+	const Session* session = find(id);
+	return (session == NULL) ? -1 : session->config;
+}
+
+/*
+ * size() - returns the number of open sessions
+ */
+size_t SessionStore::size() const{
+	return open_sessions_;
+}
+
+/*
+ * memoryUsage() - returns the bytes allocated for the sessions (pool and free list) and the configs
+ */
+size_t SessionStore::memoryUsage() const{
+	return sessions_.capacity()*sizeof(Session) + free_.capacity()*sizeof(uint32_t)
+			+ configs_.capacity()*sizeof(SessionConfig);
+}
+
+/*
+ * find() - returns the slot of the open session id or NULL if the id is unknown, closed or of an older generation
+ */
+SessionStore::Session* SessionStore::find(const SessionId id){
+	return const_cast<Session*>(static_cast<const SessionStore*>(this)->find(id));
+}
+
+const SessionStore::Session* SessionStore::find(const SessionId id) const{
+	const uint32_t slot = static_cast<uint32_t>(id);
+	if (slot >= sessions_.size()){
+		return NULL;
+	}
+	const Session& session = sessions_[slot];
+	if (!session.open || session.generation != static_cast<uint32_t>(id >> 32)){
+		return NULL;
+	}
+	return &session;
+}
+
+/*
+ * SessionWorker constructor - the worker plays the sessions of the store on its own Board and AiPlayers
+ */
+SessionWorker::SessionWorker(SessionStore& store) : store_(store) {
+}
+
+/*
+ * SessionWorker destructor
+ */
+SessionWorker::~SessionWorker() {
+}
+
+/*
+ * start() - lets the computer make the first move of a new game if it plays X
+ */
+Board::BoardStatus SessionWorker::start(const SessionId id, Move& reply){
+	GameState state;
+	if (!store_.load(id, state)){
+		throw std::invalid_argument("SESSION - not open");
+	}
+	state.restore(board_);
+	return this->reply(id, store_.getConfigIndex(id), state.getSideToMove(), reply);
+}
+
+/*
+ * play() - makes the move of the player to move in the session and the reply of the computer.
+ * The session is only changed if the move is valid.
+ */
+Board::BoardStatus SessionWorker::play(const SessionId id, const Move& move, Move& reply){
+	GameState state;
+	if (!store_.load(id, state)){
+		throw std::invalid_argument("SESSION - not open");
+	}
+	const int config = store_.getConfigIndex(id);
+	const char mark = state.getSideToMove();
+	if (state.getStatus() != Board::PLAY){
+		throw std::invalid_argument("SESSION - the game is over");
+	}
+	if (mark == store_.getConfig(config).computer_mark){
+		throw std::invalid_argument("SESSION - it is the computer's turn");
+	}
+	state.restore(board_);
+	if (!board_.validMove(move.row, move.col)){
+		throw std::invalid_argument("SESSION - invalid move");
+	}
+	board_.makeMove(move.row, move.col, mark);
+	return this->reply(id, config, (mark == 'X') ? 'O' : 'X', reply);
+}
+
+/*
+ * reply() - the board is set up with to_move to move: lets the computer move if it is its turn and the game goes on,
+ * then saves the board to the session and returns its status
+ */
+Board::BoardStatus SessionWorker::reply(const SessionId id, const int config, const char to_move, Move& reply){
+	reply = Move(0, 0);
+	char next = to_move;
+	Board::BoardStatus status = board_.evaluateBoard();
+	if (status == Board::PLAY && to_move == store_.getConfig(config).computer_mark){
+		reply = computer(config).performMove(board_, ui_);
+		next = (to_move == 'X') ? 'O' : 'X';
+		status = board_.evaluateBoard();
+	}
+	GameState state;
+	state.capture(board_, next);
+	store_.save(id, state);
+	return status;
+}
+
+/*
+ * computer() - returns the AiPlayer of the config, it is created (with the computer mark and engine of the config)
+ * the first time the config is needed. Every config keeps its own search context: the transposition table stays
+ * valid between the sessions of the config and is never cleared by sessions of another config.
+ */
+AiPlayer& SessionWorker::computer(const int config){
+	if (config >= static_cast<int>(computers_.size())){
+		computers_.resize(config + 1);
+	}
+	if (!computers_[config]){
+		const SessionConfig& session_config = store_.getConfig(config);
+		computers_[config].reset(new AiPlayer(session_config.computer_mark));
+		computers_[config]->setConfig(session_config.engine);
+	}
+	return *computers_[config];
+}
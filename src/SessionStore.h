@@ -0,0 +1,103 @@
+/*
+ * SessionStore.h
+ *
+ * SessionStore and SessionWorker class definitions.
+ * The SessionStore hosts a large number of concurrent games (sessions) in compact form: every session is a
+ * GameState plus the index of its SessionConfig, kept in one pooled array. Closed slots are reused by new sessions,
+ * the generation in the SessionId tells a reused slot from the old session. The configs (who the computer is and
+ * how it plays) are registered once and shared by all sessions using them.
+ * The heavy objects - a Board and the AiPlayers with their search contexts - belong to a SessionWorker, one per
+ * thread, which plays the moves of any session: it restores the GameState to its Board, makes the move (and the
+ * computer's reply) and stores the new GameState. The worker keeps one AiPlayer per config, created with the first
+ * move of the computer, so sessions of different configs never clear each other's transposition table.
+ * Neither class is thread-safe, a host with several threads gives each one its own store (sessions sharded by
+ * thread) and worker.
+ */
+
+#ifndef SESSIONSTORE_H_
+#define SESSIONSTORE_H_
+
+#include "AiPlayer.h"
+#include "Board.h"
+#include "GameState.h"
+#include "TUI.h"
+
+#include <cstddef>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+typedef uint64_t SessionId;								// slot of the session (low 32 bits) and its generation
+
+struct SessionConfig {									// Settings shared by all sessions of one kind of game
+	SessionConfig() : computer_mark(Board::kEmpty){};
+	char computer_mark;									// mark of the computer player (kEmpty = two human players)
+	EngineConfig engine;								// how the computer plays
+};
+
+class SessionStore {
+public:
+	static const SessionId kNoSession = 0;				// never a valid SessionId
+
+	explicit SessionStore(const size_t sessions = 0);	// Constructor - reserves space for sessions
+	virtual ~SessionStore();							// Destructor
+
+	int addConfig(const SessionConfig& config);			// registers a shared config, returns its index
+	const SessionConfig& getConfig(const int config) const;
+	int getConfigCount() const;
+
+	//opens a new game with the config, reusing the slot of a closed session if possible.
+	//Throws std::invalid_argument if the config is not registered.
+	SessionId open(const int config);
+	void close(const SessionId id);						// ends the session, its slot is reused
+	bool isOpen(const SessionId id) const;				// false for closed and unknown sessions
+
+	bool load(const SessionId id, GameState& state) const;	// snapshot of the session, false if it is not open
+	bool save(const SessionId id, const GameState& state);	// replaces the state of the session, false if it is not open
+	int getConfigIndex(const SessionId id) const;		// config of the session, -1 if it is not open
+
+	size_t size() const;								// number of open sessions
+	size_t memoryUsage() const;							// bytes used by the sessions and configs
+private:
+	struct Session {									// one slot of the pool, trivially copyable
+		GameState state;
+		uint32_t generation;							// incremented when the slot is opened, 0 = never used
+		uint16_t config;
+		bool open;
+	};
+
+	Session* find(const SessionId id);					// slot of an open session or NULL
+	const Session* find(const SessionId id) const;
+
+	std::vector<Session> sessions_;						// the pool
+	std::vector<uint32_t> free_;						// closed slots
+	std::vector<SessionConfig> configs_;
+	size_t open_sessions_;
+};
+
+class SessionWorker {
+public:
+	explicit SessionWorker(SessionStore& store);		// Constructor - the worker plays the sessions of the store
+	virtual ~SessionWorker();							// Destructor
+
+	//makes the first move of the computer if it plays X, returns the status, reply is (0, 0) if the computer
+	//did not move. Throws std::invalid_argument if the session is not open.
+	Board::BoardStatus start(const SessionId id, Move& reply);
+	//makes the move of the player to move and the reply of the computer (if it plays and the game goes on).
+	//Returns the status, reply is (0, 0) if the computer did not move. Throws std::invalid_argument if the session
+	//is not open, the game is over, it is the computer's turn or the move is invalid - the session is unchanged then.
+	Board::BoardStatus play(const SessionId id, const Move& move, Move& reply);
+private:
+	SessionWorker(const SessionWorker&);				// not copyable
+	SessionWorker& operator=(const SessionWorker&);
+
+	Board::BoardStatus reply(const SessionId id, const int config, const char to_move, Move& reply);	// computer's move
+	AiPlayer& computer(const int config);				// the AiPlayer of the config
+
+	SessionStore& store_;
+	Board board_;										// the board the moves are made on
+	std::vector< std::unique_ptr<AiPlayer> > computers_;	// by config index, shared by all sessions of the config
+	TUI ui_;											// not used, the AiPlayers need no input
+};
+
+#endif /* SESSIONSTORE_H_ */
@@ -11,24 +11,186 @@
 #include "Board.h"
 #include "Player.h"
 #include "AiPlayer.h"
+#include "Game.h"
+#include "GameSink.h"
+#include "PositionCache.h"
+#include "ScriptedPlayer.h"
+#include "SearchProfiler.h"
 #include "TUI.h"
 
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+
+/*
+ * playScript() - plays all games of a move script back to back without any prompts (load tests, replays).
+ * The script is read and validated completely before the first game starts.
+ * game_mode selects the players like the game mode menu: 1 = Computer (X) vs. script (O), 2 = script (X) vs. Computer (O),
+ * 4 = script (X) vs. script (O), the script lists the moves of both players (replay).
+ * A game whose script move is invalid (the Computer took the field) is counted as failed, the next game is played.
+ * Prints a summary of the results.
+ */
+static void playScript(std::istream& in, const int game_mode, Game& game, Board& board, TUI& ui, PositionCache* cache,
+		SearchProfiler* profiler){
+	bool replay = (game_mode == 4);
+	MoveScript script;
+	script.read(in, replay);
+
+	AiPlayer computer_x('X'), computer_o('O');
+	computer_x.setPositionCache(cache);
+	computer_o.setPositionCache(cache);
+	computer_x.setProfiler(profiler);
+	computer_o.setProfiler(profiler);
+	ScriptedPlayer script_x('X'), script_o('O');
+	Player* player_x = (game_mode == 1) ? static_cast<Player*>(&computer_x) : &script_x;
+	Player* player_o = (game_mode == 2) ? static_cast<Player*>(&computer_o) : &script_o;
+
+	int results[4] = {0, 0, 0, 0};			// games per Board::BoardStatus, PLAY counts failed games
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int i=0,max=script.getGameCount(); i<max; i++){
+		int next_move = 0;					// shared by both scripted players in a replay
+		int next_move_o = 0;
+		script_x.setMoves(&script.getGame(i), &next_move);
+		script_o.setMoves(&script.getGame(i), replay ? &next_move : &next_move_o);
+		board.resetBoard();
+		try {
+			results[game.play(board, *player_x, *player_o)]++;
+		} catch (const std::invalid_argument& e){
+			results[Board::PLAY]++;
+			std::cerr << "line " << script.getLine(i) << ": " << e.what() << std::endl;
+		}
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::ostringstream summary;
+	summary << "\nPlayed " << script.getGameCount() << " games in " << seconds << " s";
+	if (seconds > 0){
+		summary << " (" << script.getGameCount()/seconds << " games/s)";
+	}
+	summary << ".\nX won: " << results[Board::WINX] << ", O won: " << results[Board::WINO]
+			<< ", draw: " << results[Board::DRAW] << ", failed: " << results[Board::PLAY];
+	ui.message(summary.str());
+}
 
 
-int main (){
+int main (int argc, char* argv[]){
 
 	TUI ui;					// create ui for user input / output
 	Board myboard; 			// create a board
 
-	Player *players[2];		// create an array for players - its an array of pointers to player objects to be created at a later stage.
+	// the game output goes to a GameSink, selected by the command line option --output=tui|buffered|null
+	TuiGameSink tui_sink(ui);
+	BufferedGameSink buffered_sink;
+	NullGameSink null_sink;
+	GameSink* sink = &tui_sink;
+
+	// the games can be read from a script instead of the user: --script=FILE (- for standard input) --mode=1|2|4
+	std::string script_file;
+	int script_mode = 4;
+	bool script_mode_set = false;
+
+	// the computer players can share their results with other processes through a cache file: --cache=FILE
+	std::string cache_file;
+	PositionCache cache;
+
+	// the moves of the computer players can be profiled with the hardware counters (report to stderr):
+	// --profile, --profile-trace=FILE additionally writes a Chrome trace of the search phases
+	bool profile = false;
+	std::string trace_file;
+
+	const std::string usage = std::string("Usage: ") + argv[0] + " [--output=tui|buffered|null] [--cache=FILE] [--profile]"
+			" [--profile-trace=FILE] [--script=FILE|- [--mode=1|2|4]]";
+	for (int i=1; i<argc; i++){
+		std::string option = argv[i];
+		if (option.compare(0, 9, "--script=") == 0 && option.size() > 9){
+			script_file = option.substr(9);
+		} else if (option.compare(0, 8, "--cache=") == 0 && option.size() > 8){
+			cache_file = option.substr(8);
+		} else if (option == "--profile"){
+			profile = true;
+		} else if (option.compare(0, 16, "--profile-trace=") == 0 && option.size() > 16){
+			profile = true;
+			trace_file = option.substr(16);
+		} else if (option == "--mode=1" || option == "--mode=2" || option == "--mode=4"){
+			script_mode = option[7] - '0';
+			script_mode_set = true;
+		} else if (option == "--output=tui"){
+			sink = &tui_sink;
+		} else if (option == "--output=buffered"){		// whole frames in one write() call
+			sink = &buffered_sink;
+		} else if (option == "--output=null"){			// no game output at all
+			sink = &null_sink;
+		} else {
+			std::cerr << usage << std::endl;
+			return 1;
+		}
+	}
+	if (script_mode_set && script_file.empty()){
+		std::cerr << usage << std::endl << "--mode is only used with --script" << std::endl;
+		return 1;
+	}
+	Game game(ui, *sink);	// the game loop
+
+	if (!cache_file.empty()){
+		try {
+			cache.open(cache_file);
+		}
+		catch(const std::exception& e){
+			std::cerr << e.what() << " - QUITTING." << std::endl;
+			return 1;
+		}
+	}
+	PositionCache* shared_cache = cache_file.empty() ? NULL : &cache;
+
+	std::unique_ptr<SearchProfiler> profiler;
+	if (profile){
+		profiler.reset(new SearchProfiler());
+		if (!trace_file.empty() && !profiler->openTrace(trace_file)){
+			std::cerr << "CANNOT CREATE TRACE " << trace_file << " - QUITTING." << std::endl;
+			return 1;
+		}
+	}
+
+	if (!script_file.empty()){
+		try {
+			if (script_file == "-"){
+				playScript(std::cin, script_mode, game, myboard, ui, shared_cache, profiler.get());
+			} else {
+				std::ifstream script_stream(script_file.c_str());
+				if (!script_stream){
+					throw std::invalid_argument("CANNOT OPEN SCRIPT " + script_file);
+				}
+				playScript(script_stream, script_mode, game, myboard, ui, shared_cache, profiler.get());
+			}
+		}
+		catch(const std::exception& e){
+			std::cerr << e.what() << " - QUITTING." << std::endl;
+			return 1;
+		}
+		catch (const char* msg){
+			std::cerr << msg << " - QUITTING." << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// the players are created once and reused for every game, so the AiPlayers keep their search context (tables)
+	Player human_x('X'), human_o('O');
+	AiPlayer computer_x('X'), computer_o('O');
+	computer_x.setPositionCache(shared_cache);
+	computer_o.setPositionCache(shared_cache);
+	computer_x.setProfiler(profiler.get());
+	computer_o.setProfiler(profiler.get());
+	Player *players[2];		// create an array for players - its an array of pointers to the players of the current game.
 
 	bool game_replay = false;
 	int game_mode_answer = -1;
 	int game_replay_answer = -1;
-	int current_player = 0;
 
 	// Lets put the text and prompts for communicating with the user in one place
 
@@ -42,15 +204,6 @@ int main (){
 					<< "You win if you have " << Board::kWinLine << " symbols in a row.\n"
 					<< "Player X starts the game.";
 
-	std::ostringstream game_draw_msg;
-	game_draw_msg << "\nGAME OVER - The game is a DRAW.";
-
-	std::ostringstream game_winx_msg;
-	game_winx_msg << "\nGAME OVER - Player X WON the game.";
-
-	std::ostringstream game_wino_msg;
-	game_wino_msg << "\nGAME OVER - Player O WON the game.";
-
 	// Game mode dialogue
 	std::ostringstream game_mode_dialogue, game_mode_prompt;
 	game_mode_dialogue	<< "\nPlease choose game mode:\n\n"
@@ -77,7 +230,6 @@ int main (){
 	try {										// this part is risky, lets catch exceptions.
 		do {
 			game_replay = false;		//make sure we don't go into an infinite loop
-			current_player = 0;			//reset the player that starts
 			game_mode_answer = -1;		//reset game mode answer
 
 			// get the game mode input from user and store it in game_mode_answer
@@ -88,63 +240,36 @@ int main (){
 			case 0:
 				return 0;
 			case 1:
-				players[0]= new AiPlayer('X');	// allocate space for and create an instance of AiPlayer - space must be explicitly released at the end!!!
-				players[1]= new Player('O');	// allocate space for and create an instance of Player - space must be explicitly released at the end!!!
+				players[0]= &computer_x;
+				players[1]= &human_o;
 				break;
 			case 2:
-				players[0]= new Player('X');
-				players[1]= new AiPlayer('O');
+				players[0]= &human_x;
+				players[1]= &computer_o;
 				break;
 			case 3:
-				players[0]= new AiPlayer('X');
-				players[1]= new AiPlayer('O');
+				players[0]= &computer_x;
+				players[1]= &computer_o;
 				break;
 			case 4:
-				players[0]= new Player('X');
-				players[1]= new Player('O');
+				players[0]= &human_x;
+				players[1]= &human_o;
 				break;
 			/*case 5: // Test Case for AI quality
-				players[0]= new AiPlayer('X');
-				players[1]= new AiPlayer('O');
+				players[0]= &computer_o;			// O is to move - Game::play() starts with the first player
+				players[1]= &computer_x;
 				myboard.makeMove(1,2,'X');
 				myboard.makeMove(2,3,'X');
 				myboard.makeMove(3,3,'X');
 				myboard.makeMove(3,1,'O');
 				myboard.makeMove(3,2,'O');
-				current_player = 1;
 				break;*/
 			default:
 				// this is reached only if answer was not modified - this should never happen.
 				throw "UNREACHEABLE CODE - Error in program flow";
 			}
 
-			while (myboard.evaluateBoard()== Board::PLAY){			// while we can play
-				myboard.printBoard(ui);								// print current board status
-				players[current_player]->performMove(myboard,ui);	// get the move from Player or AiPlayer
-				if (current_player == 0){							// swap the players
-					current_player = 1;
-				} else {
-					current_player = 0;
-				}
-			}
-			myboard.printBoard(ui);									// display the final board on the screen
-
-			Board::BoardStatus final_status = myboard.evaluateBoard(); // evaluate the board status
-
-			switch (final_status){
-			case Board::DRAW:
-				ui.message(game_draw_msg.str());
-				break;
-			case Board::WINX:
-				ui.message(game_winx_msg.str());
-				break;
-			case Board::WINO:
-				ui.message(game_wino_msg.str());
-				break;
-			default:
-				// this is reached only if answer was not modified - this should never happen.
-				throw "UNREACHEABLE CODE - Error in program flow";
-			}
+			game.play(myboard, *players[0], *players[1]);			// play the game, the sink displays it
 
 			game_replay_answer = -1;			//reset game replay answer
 
@@ -154,12 +279,8 @@ int main (){
 			// evaluate the game_replay_answer
 			switch (game_replay_answer){
 			case 0:
-				delete players[0];		//free up the storage
-				delete players[1];		//free up the storage
 				return 0;
 			case 1:
-				delete players[0];		//free up the storage
-				delete players[1];		//free up the storage
 				myboard.resetBoard();
 				game_replay = true;
 				break;
@@ -180,7 +301,5 @@ int main (){
 	catch(...){ //catch all other exceptions
 		std::cerr << "An unexpected error has occurred. - QUITTING" << std::endl;
 	}
-	delete players[0];		//free up the storage
-	delete players[1];		//free up the storage
 	return 0;
 }
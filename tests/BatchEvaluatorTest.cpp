@@ -0,0 +1,131 @@
+/*
+ * BatchEvaluatorTest.cpp
+ *
+ * Tests of the BatchEvaluator: the status of random positions agrees with Board::evaluateBoard() and the score
+ * with a plain scan of the win lines, for the table kernel (3x3) and the win line kernel (e.g. 8x8), split over
+ * threads or not. Boards over 64 fields only check that evaluate() throws.
+ *
+ *   g++ -O2 -pthread -Isrc tests/BatchEvaluatorTest.cpp src/BatchEvaluator.cpp src/Board.cpp src/TUI.cpp \
+ *       -o batch_test
+ *   g++ -O2 -pthread -DTICTACTOE_ROWS=8 -DTICTACTOE_COLS=8 -DTICTACTOE_WIN_LINE=5 -Isrc tests/BatchEvaluatorTest.cpp \
+ *       src/BatchEvaluator.cpp src/Board.cpp src/TUI.cpp -o batch_test
+ */
+
+#include "Check.h"
+#include "Board.h"
+#include "BatchEvaluator.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/*
+ * lineScore() - heuristic score of the board (view of X) by scanning the fields of every win line
+ */
+static int32_t lineScore(const Board& board){
+	const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+	int32_t score = 0;
+	for (int i=1; i<=Board::kRows; i++){
+		for (int j=1; j<=Board::kCols; j++){
+			for (int d=0; d<4; d++){
+				int end_row = i + directions[d][0]*(Board::kWinLine-1);
+				int end_col = j + directions[d][1]*(Board::kWinLine-1);
+				if (end_row > Board::kRows || end_col < 1 || end_col > Board::kCols){
+					continue;
+				}
+				int x = 0, o = 0;
+				for (int k=0; k<Board::kWinLine; k++){
+					uint64_t bit = 1ULL << ((i-1 + directions[d][0]*k)*Board::kCols + j-1 + directions[d][1]*k);
+					x += (board.getMarks('X') & bit) != 0;
+					o += (board.getMarks('O') & bit) != 0;
+				}
+				if (x > 0 && o == 0){
+					score += 1 << (std::min(3*x, 21) - 3);
+				} else if (o > 0 && x == 0){
+					score -= 1 << (std::min(3*o, 21) - 3);
+				}
+			}
+		}
+	}
+	return score;
+}
+
+/*
+ * testRandomPositions() - positions of random games (also dead draws and games played on after a win) evaluated
+ * in one batch on one thread and on four threads
+ */
+static void testRandomPositions(){
+	std::mt19937 random(37);
+	std::vector<Board> boards;
+	for (int game=0; game<4000; game++){
+		Board board;
+		char mark = 'X';
+		int marks = random() % (Board::kRows*Board::kCols + 1);
+		for (int n=0; n<marks; n++){
+			int row, col;
+			do {
+				row = random() % Board::kRows + 1;
+				col = random() % Board::kCols + 1;
+			} while (!board.validMove(row, col));
+			board.makeMove(row, col, mark);
+			mark = (mark == 'X') ? 'O' : 'X';
+		}
+		boards.push_back(board);
+	}
+	const size_t count = 4*BatchEvaluator::kMinPositionsPerThread;	//enough positions for four threads
+	std::vector<uint64_t> x(count), o(count);
+	for (size_t i=0; i<count; i++){
+		BatchEvaluator::pack(boards[i % boards.size()], x[i], o[i]);
+	}
+	std::vector<unsigned char> status(count), threaded_status(count);
+	std::vector<int32_t> score(count), threaded_score(count);
+	BatchEvaluator evaluator;
+	EvaluationBatch results(&status[0], &score[0]);
+	EvaluationBatch threaded_results(&threaded_status[0], &threaded_score[0]);
+	evaluator.evaluate(PositionBatch(&x[0], &o[0], count), results, 1);
+	evaluator.evaluate(PositionBatch(&x[0], &o[0], count), threaded_results, 4);
+
+	for (size_t i=0; i<boards.size(); i++){
+		const Board::BoardStatus expected = boards[i].evaluateBoard();
+		CHECK(status[i] == expected);
+		if (expected == Board::WINX){
+			CHECK(score[i] == BatchEvaluator::kWinScore);
+		} else if (expected == Board::WINO){
+			CHECK(score[i] == -BatchEvaluator::kWinScore);
+		} else if (expected == Board::DRAW){
+			CHECK(score[i] == 0);
+		} else {
+			CHECK(score[i] == lineScore(boards[i]));
+		}
+	}
+	CHECK(status == threaded_status);
+	CHECK(score == threaded_score);
+}
+
+/*
+ * testUnavailable() - boards over 64 fields: evaluate() throws
+ */
+static void testUnavailable(){
+	BatchEvaluator evaluator;
+	uint64_t x = 0, o = 0;
+	unsigned char status = 0;
+	int32_t score = 0;
+	EvaluationBatch results(&status, &score);
+	bool thrown = false;
+	try {
+		evaluator.evaluate(PositionBatch(&x, &o, 1), results);
+	} catch (const std::logic_error&){
+		thrown = true;
+	}
+	CHECK(thrown);
+}
+
+int main(){
+	if (BatchEvaluator::kAvailable){
+		testRandomPositions();
+	} else {
+		testUnavailable();
+	}
+	return check::finish("BatchEvaluatorTest");
+}
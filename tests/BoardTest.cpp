@@ -0,0 +1,241 @@
+/*
+ * BoardTest.cpp
+ *
+ * Tests of the Board: the incrementally counted win lines are compared with a brute force scan of the fields
+ * after random sequences of makeMove() and removeMove(), the canonical hash is checked on rotated and mirrored
+ * positions. The board size is set at compile time, the tests hold for any size, e.g.:
+ *
+ *   g++ -O2 -DTICTACTOE_ROWS=3 -DTICTACTOE_COLS=5 -DTICTACTOE_WIN_LINE=4 -Isrc tests/BoardTest.cpp src/Board.cpp \
+ *       src/TUI.cpp -o board_test
+ */
+
+#include "Check.h"
+#include "Board.h"
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * BruteBoard - the fields of a Board kept as a plain array, every question is answered by scanning all win lines
+ */
+struct BruteBoard {
+	char fields[Board::kRows][Board::kCols];
+	std::vector< std::vector<Move> > lines;				// fields of every win line (row and column from 0)
+
+	BruteBoard() {
+		const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+		for (int i=0; i<Board::kRows; i++){
+			for (int j=0; j<Board::kCols; j++){
+				fields[i][j] = Board::kEmpty;
+				for (int d=0; d<4; d++){
+					std::vector<Move> line;
+					for (int k=0; k<Board::kWinLine; k++){
+						int row = i + directions[d][0]*k;
+						int col = j + directions[d][1]*k;
+						if (row >= 0 && row < Board::kRows && col >= 0 && col < Board::kCols){
+							line.push_back(Move(row, col));
+						}
+					}
+					if (static_cast<int>(line.size()) == Board::kWinLine){
+						lines.push_back(line);
+					}
+				}
+			}
+		}
+	}
+
+	int count(const std::vector<Move>& line, const char mark) const{
+		int marks = 0;
+		for (int k=0,max=line.size(); k<max; k++){
+			marks += (fields[line[k].row][line[k].col] == mark);
+		}
+		return marks;
+	}
+
+	Board::BoardStatus status() const{
+		bool x_wins = false, o_wins = false, open = false, full = true;
+		for (int l=0,max=lines.size(); l<max; l++){
+			int x = count(lines[l], 'X');
+			int o = count(lines[l], 'O');
+			x_wins = x_wins || x == Board::kWinLine;
+			o_wins = o_wins || o == Board::kWinLine;
+			open = open || x == 0 || o == 0;
+		}
+		for (int i=0; i<Board::kRows; i++){
+			for (int j=0; j<Board::kCols; j++){
+				full = full && fields[i][j] != Board::kEmpty;
+			}
+		}
+		if (x_wins){
+			return Board::WINX;
+		} else if (o_wins){
+			return Board::WINO;
+		}
+		return (full || !open) ? Board::DRAW : Board::PLAY;
+	}
+
+	//does a line through the field have marks of mark in all but needed fields and no mark of the opponent?
+	bool lineWith(const int row, const int col, const char mark, const int missing) const{
+		const char opponent = (mark == 'X') ? 'O' : 'X';
+		for (int l=0,max=lines.size(); l<max; l++){
+			bool through = false;
+			for (int k=0; k<Board::kWinLine; k++){
+				through = through || (lines[l][k].row == row && lines[l][k].col == col);
+			}
+			if (through && count(lines[l], opponent) == 0 && count(lines[l], mark) == Board::kWinLine - missing){
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+/*
+ * testLineCount() - kLineCount is the number of win lines that fit on the board
+ */
+static void testLineCount(){
+	BruteBoard brute;
+	CHECK(static_cast<int>(brute.lines.size()) == Board::kLineCount);
+}
+
+/*
+ * testCounters() - status, winningMove() and threatMove() agree with the brute force scan after every change of
+ * random games in which marks are also removed and replaced
+ */
+static void testCounters(){
+	std::mt19937 random(30);
+	for (int game=0; game<2000; game++){
+		Board board;
+		BruteBoard brute;
+		std::vector<Move> played;
+		char mark = 'X';
+		for (int step=0; step<3*Board::kRows*Board::kCols; step++){
+			if (!played.empty() && random() % 4 == 0){				// take a random move back
+				int index = random() % played.size();
+				Move move = played[index];
+				played.erase(played.begin() + index);
+				board.removeMove(move.row + 1, move.col + 1);
+				brute.fields[move.row][move.col] = Board::kEmpty;
+			} else if (static_cast<int>(played.size()) < Board::kRows*Board::kCols){
+				int row, col;
+				do {
+					row = random() % Board::kRows;
+					col = random() % Board::kCols;
+				} while (!board.validMove(row + 1, col + 1));
+				CHECK(board.winningMove(row + 1, col + 1, mark) == brute.lineWith(row, col, mark, 1));
+				CHECK(board.threatMove(row + 1, col + 1, mark) == brute.lineWith(row, col, mark, 2));
+				board.makeMove(row + 1, col + 1, mark);
+				brute.fields[row][col] = mark;
+				played.push_back(Move(row, col));
+				mark = (mark == 'X') ? 'O' : 'X';
+			}
+			CHECK(board.evaluateBoard() == brute.status());
+		}
+	}
+}
+
+/*
+ * testHash() - the incremental hash depends on the position only, not on the order of the moves
+ */
+static void testHash(){
+	Board board;
+	const uint64_t empty = board.getHash();
+	board.makeMove(1, 1, 'X');
+	board.makeMove(Board::kRows, Board::kCols, 'O');
+	const uint64_t hash = board.getHash();
+	Board other;
+	other.makeMove(Board::kRows, Board::kCols, 'O');
+	other.makeMove(1, 1, 'X');
+	CHECK(other.getHash() == hash);
+	board.removeMove(1, 1);
+	board.removeMove(Board::kRows, Board::kCols);
+	CHECK(board.getHash() == empty);
+}
+
+/*
+ * Grid - the marks of a position, row by row, used to build the rotated and mirrored positions
+ */
+typedef std::vector<std::string> Grid;
+
+static Grid randomGrid(std::mt19937& random){
+	Grid grid(Board::kRows, std::string(Board::kCols, Board::kEmpty));
+	const char marks[3] = {Board::kEmpty, 'X', 'O'};
+	for (int i=0; i<Board::kRows; i++){
+		for (int j=0; j<Board::kCols; j++){
+			grid[i][j] = marks[random() % 3];
+		}
+	}
+	return grid;
+}
+
+//the symmetry s: bit 0 mirrors the rows, bit 1 the columns, bit 2 transposes (square boards only)
+static Grid transform(const Grid& grid, const int s){
+	Grid image = grid;
+	for (int i=0; i<Board::kRows; i++){
+		for (int j=0; j<Board::kCols; j++){
+			int row = (s & 1) ? Board::kRows-1-i : i;
+			int col = (s & 2) ? Board::kCols-1-j : j;
+			if (s & 4){
+				image[col][row] = grid[i][j];
+			} else {
+				image[row][col] = grid[i][j];
+			}
+		}
+	}
+	return image;
+}
+
+static void fill(Board& board, const Grid& grid){
+	for (int i=0; i<Board::kRows; i++){
+		for (int j=0; j<Board::kCols; j++){
+			if (grid[i][j] != Board::kEmpty){
+				board.makeMove(i + 1, j + 1, grid[i][j]);
+			}
+		}
+	}
+}
+
+/*
+ * testCanonicalHash() - all rotated and mirrored positions share the canonical hash, positions which are no
+ * images of each other get different ones
+ */
+static void testCanonicalHash(){
+	const int symmetries = (Board::kRows == Board::kCols) ? 8 : 4;
+	std::mt19937 random(33);
+	std::map<uint64_t, Grid> classes;			//canonical hash -> smallest image of the position
+	int collisions = 0;
+	for (int n=0; n<5000; n++){
+		Grid grid = randomGrid(random);
+		Board board;
+		fill(board, grid);
+		Grid smallest = grid;
+		for (int s=1; s<symmetries; s++){
+			Grid image = transform(grid, s);
+			Board other;
+			fill(other, image);
+			CHECK(other.getCanonicalHash() == board.getCanonicalHash());
+			smallest = std::min(smallest, image);
+		}
+		std::map<uint64_t, Grid>::iterator found = classes.find(board.getCanonicalHash());
+		if (found == classes.end()){
+			classes[board.getCanonicalHash()] = smallest;
+		} else {
+			collisions += (found->second != smallest);
+		}
+	}
+	CHECK(collisions == 0);
+	Board empty;
+	Board corner;
+	corner.makeMove(1, 1, 'X');
+	CHECK(corner.getCanonicalHash() != empty.getCanonicalHash());
+}
+
+int main(){
+	testLineCount();
+	testCounters();
+	testHash();
+	testCanonicalHash();
+	return check::finish("BoardTest");
+}
@@ -0,0 +1,42 @@
+/*
+ * Check.h
+ *
+ * Minimal checks for the test programs in tests/. CHECK() counts the conditions and reports every failed one with
+ * its file and line, finish() prints the summary and returns the exit code of the test program (0 = all passed).
+ */
+
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#include <iostream>
+
+namespace check {
+
+inline int& checks(){									// number of checked conditions
+	static int count = 0;
+	return count;
+}
+
+inline int& failures(){									// number of failed conditions
+	static int count = 0;
+	return count;
+}
+
+inline void report(const bool passed, const char* condition, const char* file, const int line){
+	checks()++;
+	if (!passed){
+		failures()++;
+		std::cerr << file << ":" << line << ": check failed: " << condition << std::endl;
+	}
+}
+
+inline int finish(const char* test){
+	std::cout << test << ": " << checks() - failures() << " of " << checks() << " checks passed" << std::endl;
+	return (failures() == 0) ? 0 : 1;
+}
+
+}
+
+#define CHECK(condition) check::report((condition), #condition, __FILE__, __LINE__)
+
+#endif /* CHECK_H_ */
@@ -0,0 +1,93 @@
+/*
+ * MoveScriptTest.cpp
+ *
+ * Tests of the move script parser and validation (MoveScript::read()) on the default 3x3 board.
+ *
+ *   g++ -O2 -Isrc tests/MoveScriptTest.cpp src/ScriptedPlayer.cpp src/Player.cpp src/Board.cpp src/TUI.cpp \
+ *       -o move_script_test
+ */
+
+#include "Check.h"
+#include "ScriptedPlayer.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+/*
+ * readError() - reads the script, returns the message of the std::invalid_argument thrown (empty if it is valid)
+ */
+static std::string readError(const std::string& text, const bool all_moves){
+	std::istringstream in(text);
+	MoveScript script;
+	try {
+		script.read(in, all_moves);
+	} catch (const std::invalid_argument& e){
+		return e.what();
+	}
+	return "";
+}
+
+static bool contains(const std::string& text, const std::string& part){
+	return text.find(part) != std::string::npos;
+}
+
+/*
+ * testValidScript() - games, comments and empty lines are read, moves are column,row
+ */
+static void testValidScript(){
+	std::istringstream in("# recorded games\n\n2,2 1,1 3,1\n  \n1,3\n");
+	MoveScript script;
+	script.read(in, false);
+	CHECK(script.getGameCount() == 2);
+	CHECK(script.getGame(0).size() == 3);
+	CHECK(script.getGame(0)[2].col == 3 && script.getGame(0)[2].row == 1);
+	CHECK(script.getLine(0) == 3);
+	CHECK(script.getLine(1) == 5);
+}
+
+/*
+ * testParseErrors() - malformed moves are reported with their line
+ */
+static void testParseErrors(){
+	CHECK(contains(readError("2;2\n", false), "line 1: invalid move '2;2'"));
+	CHECK(contains(readError("2,\n", false), "invalid move"));
+	CHECK(contains(readError(",2\n", false), "invalid move"));
+	CHECK(contains(readError("2,2x\n", false), "invalid move"));
+	CHECK(contains(readError("1,1 # comment after a move\n", false), "invalid move '#'"));
+	CHECK(contains(readError("4,1\n", false), "move 1 is outside of the board"));
+	CHECK(contains(readError("0,1\n", false), "outside of the board"));
+	CHECK(contains(readError("1,1 1,1\n", false), "move 2 is outside of the board or on an occupied field"));
+}
+
+/*
+ * testErrorsAreCollected() - every invalid line is reported in one exception, valid lines are not
+ */
+static void testErrorsAreCollected(){
+	std::string error = readError("1,1\nx\n2,2\n9,9\n", false);
+	CHECK(contains(error, "INVALID SCRIPT - 2 invalid line(s)"));
+	CHECK(contains(error, "line 2:"));
+	CHECK(contains(error, "line 4:"));
+	CHECK(!contains(error, "line 1:") && !contains(error, "line 3:"));
+}
+
+/*
+ * testReplayValidation() - replays (all moves) have to end the game and may not continue after a win,
+ * moves after a dead draw are accepted
+ */
+static void testReplayValidation(){
+	CHECK(readError("1,1 1,2 2,1 2,2 3,1\n", true) == "");							// X wins with the last move
+	CHECK(contains(readError("1,1 1,2 2,1\n", true), "the game is not finished"));
+	CHECK(contains(readError("1,1 1,2 2,1 2,2 3,1 3,3\n", true), "move 6 is played after the end of the game"));
+	CHECK(readError("1,1 2,1 3,1 2,2 1,2 3,2 2,3 1,3 3,3\n", true) == "");			// full board, dead draw before
+	CHECK(readError("1,1 2,1 3,1 2,2 1,2 3,2 2,3 1,3\n", true) == "");				// ends at the dead draw
+	CHECK(readError("1,1 1,2 2,1\n", false) == "");									// one player's moves only
+}
+
+int main(){
+	testValidScript();
+	testParseErrors();
+	testErrorsAreCollected();
+	testReplayValidation();
+	return check::finish("MoveScriptTest");
+}
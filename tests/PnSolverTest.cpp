@@ -0,0 +1,110 @@
+/*
+ * PnSolverTest.cpp
+ *
+ * Tests of the PnSolver: the known values of small games and the agreement with a plain minimax search on random
+ * positions. The board size is set at compile time, run the test for the sizes with known values:
+ *
+ *   g++ -O2 -Isrc tests/PnSolverTest.cpp src/PnSolver.cpp src/Board.cpp src/TUI.cpp -o pn_test
+ *   g++ -O2 -DTICTACTOE_WIN_LINE=2 -Isrc tests/PnSolverTest.cpp src/PnSolver.cpp src/Board.cpp src/TUI.cpp -o pn_test
+ *   g++ -O2 -DTICTACTOE_ROWS=4 -DTICTACTOE_COLS=4 -Isrc tests/PnSolverTest.cpp src/PnSolver.cpp src/Board.cpp \
+ *       src/TUI.cpp -o pn_test
+ */
+
+#include "Check.h"
+#include "Board.h"
+#include "PnSolver.h"
+
+#include <random>
+
+/*
+ * miniMax() - value of the board with the player with mark to move, searched without any pruning
+ */
+static PnSolver::Result miniMax(Board& board, const char mark){
+	switch (board.evaluateBoard()){
+	case Board::WINX:
+		return PnSolver::kWinX;
+	case Board::WINO:
+		return PnSolver::kWinO;
+	case Board::DRAW:
+		return PnSolver::kDraw;
+	default:
+		break;
+	}
+	const char opponent = (mark == 'X') ? 'O' : 'X';
+	PnSolver::Result best = (mark == 'X') ? PnSolver::kWinO : PnSolver::kWinX;
+	for (int i=1; i<=Board::kRows; i++){
+		for (int j=1; j<=Board::kCols; j++){
+			if (!board.validMove(i, j)){
+				continue;
+			}
+			board.makeMove(i, j, mark);
+			PnSolver::Result result = miniMax(board, opponent);
+			board.removeMove(i, j);
+			if ((mark == 'X') ? result < best : result > best){	//kWinX < kDraw < kWinO
+				best = result;
+			}
+		}
+	}
+	return best;
+}
+
+/*
+ * testKnownValues() - the empty board: 3x3 with 3 in a row is a draw, 3x3 with 2 and 4x4 with 3 in a row X wins
+ */
+static void testKnownValues(){
+	PnSolver solver(1 << 20);
+	Board board;
+	PnSolver::Result result = solver.solve(board, 'X');
+	if (Board::kRows == 3 && Board::kCols == 3 && Board::kWinLine == 3){
+		CHECK(result == PnSolver::kDraw);
+	} else if (Board::kRows == 3 && Board::kCols == 3 && Board::kWinLine == 2){
+		CHECK(result == PnSolver::kWinX);
+	} else if (Board::kRows == 4 && Board::kCols == 4 && Board::kWinLine == 3){
+		CHECK(result == PnSolver::kWinX);
+	}
+	CHECK(board.getHash() == Board().getHash());		//the board is left unchanged
+}
+
+/*
+ * testRandomPositions() - the solver agrees with miniMax() on random positions of running games, also with a table
+ * so small that the garbage collection runs (on boards larger than 3x3)
+ */
+static void testRandomPositions(){
+	std::mt19937 random(32);
+	PnSolver solver(1 << 20);
+	PnSolver small(1024);								//the smallest table allowed
+	unsigned long long collections = 0;
+	const int fields = Board::kRows*Board::kCols;
+	const int min_marks = (fields > 9) ? fields - 9 : 0;		//keep miniMax() within 9 free fields
+	int positions = 0;
+	while (positions < 300){
+		Board board;
+		char mark = 'X';
+		int marks = min_marks + random() % (fields - min_marks);
+		for (int n=0; n<marks && board.evaluateBoard() == Board::PLAY; n++){
+			int row, col;
+			do {
+				row = random() % Board::kRows + 1;
+				col = random() % Board::kCols + 1;
+			} while (!board.validMove(row, col));
+			board.makeMove(row, col, mark);
+			mark = (mark == 'X') ? 'O' : 'X';
+		}
+		if (board.evaluateBoard() != Board::PLAY){
+			continue;
+		}
+		PnSolver::Result expected = miniMax(board, mark);
+		CHECK(solver.solve(board, mark) == expected);
+		CHECK(small.solve(board, mark) == expected);
+		CHECK(small.getTableSize() <= 1024);
+		collections += small.getCollections();
+		positions++;
+	}
+	CHECK(Board::kRows*Board::kCols <= 9 || collections > 0);	//small boards fit into the table
+}
+
+int main(){
+	testKnownValues();
+	testRandomPositions();
+	return check::finish("PnSolverTest");
+}
@@ -0,0 +1,92 @@
+/*
+ * SearchContextTest.cpp
+ *
+ * Tests of the reusable search context of the AiPlayer: a player reset by newGame() searches exactly like a new
+ * player, the transposition table of an earlier game must not change its moves.
+ *
+ *   g++ -O2 -Isrc tests/SearchContextTest.cpp src/AiPlayer.cpp src/SearchContext.cpp src/SearchProfiler.cpp \
+ *       src/PerfCounters.cpp src/PositionCache.cpp src/Player.cpp src/Board.cpp src/TUI.cpp -o search_context_test
+ */
+
+#include "Check.h"
+#include "AiPlayer.h"
+
+#include <random>
+#include <vector>
+
+/*
+ * randomPosition() - plays up to plies random moves from the empty board, returns the mark to move
+ */
+static char randomPosition(Board& board, const int plies, std::mt19937& random){
+	char mark = 'X';
+	for (int i=0; i<plies && board.evaluateBoard() == Board::PLAY; i++){
+		int row, col;
+		do {
+			row = random() % Board::kRows + 1;
+			col = random() % Board::kCols + 1;
+		} while (!board.validMove(row, col));
+		board.makeMove(row, col, mark);
+		mark = (mark == 'X') ? 'O' : 'X';
+	}
+	return mark;
+}
+
+/*
+ * testNewGameIsFresh() - the same search in every game after newGame() gives the move and score of the first game
+ * (the empty board hashes to 0 and was skipped by the table when stale entries were left)
+ */
+static void testNewGameIsFresh(){
+	AiPlayer player('X');
+	Board board;
+	AiMove first = player.searchMove(board, SearchLimits(AiPlayer::kLookAhead));
+	for (int game=0; game<3; game++){
+		player.newGame();
+		AiMove move = player.searchMove(board, SearchLimits(AiPlayer::kLookAhead));
+		CHECK(move.row == first.row);
+		CHECK(move.col == first.col);
+		CHECK(move.score == first.score);
+	}
+}
+
+/*
+ * testResetMatchesNewPlayer() - after searching other positions and newGame(), a player finds the same moves as
+ * a player which has never searched
+ */
+static void testResetMatchesNewPlayer(){
+	std::mt19937 random(26);
+	AiPlayer used_x('X'), used_o('O');
+	for (int i=0; i<200; i++){
+		Board board;
+		const char mark = randomPosition(board, random() % (Board::kRows*Board::kCols), random);
+		if (board.evaluateBoard() != Board::PLAY){
+			continue;
+		}
+		AiPlayer& used = (mark == 'X') ? used_x : used_o;
+		used.searchMove(board, SearchLimits(AiPlayer::kLookAhead));		// fill the tables
+		used.newGame();
+		AiPlayer fresh(mark);
+		AiMove expected = fresh.searchMove(board, SearchLimits(AiPlayer::kLookAhead));
+		AiMove move = used.searchMove(board, SearchLimits(AiPlayer::kLookAhead));
+		CHECK(move.row == expected.row && move.col == expected.col && move.score == expected.score);
+	}
+}
+
+/*
+ * testTableKeepsResultsWithinGame() - without newGame() the second search of a position is answered (at least
+ * partly) from the table and gives the same move
+ */
+static void testTableKeepsResultsWithinGame(){
+	AiPlayer player('X');
+	Board board;
+	AiMove first = player.searchMove(board, SearchLimits(AiPlayer::kLookAhead));
+	AiMove second = player.searchMove(board, SearchLimits(AiPlayer::kLookAhead));
+	CHECK(second.row == first.row && second.col == first.col);
+	CHECK(player.getStatistics().table_hits > 0);
+}
+
+int main(){
+	testNewGameIsFresh();
+	testResetMatchesNewPlayer();
+	testTableKeepsResultsWithinGame();
+	return check::finish("SearchContextTest");
+}
@@ -0,0 +1,97 @@
+/*
+ * analyze.cpp
+ *
+ * analyze - standalone tool printing the best moves of a tic-tac-toe position with their scores and principal
+ * variations, found by one multi-PV search of the AiPlayer (AiPlayer::analyze()).
+ * The board size is set at compile time, e.g. for 4x4 with 3 in a row:
+ *
+ *   g++ -O2 -DTICTACTOE_ROWS=4 -DTICTACTOE_COLS=4 -DTICTACTOE_WIN_LINE=3 -Isrc tools/analyze.cpp \
+ *       src/AiPlayer.cpp src/SearchContext.cpp src/SearchProfiler.cpp src/PerfCounters.cpp src/PositionCache.cpp \
+ *       src/Player.cpp src/Board.cpp src/TUI.cpp -o analyze
+ *
+ * Usage: analyze [--lines=N] [--look-ahead=N] [--millis=N] [column,row ...]
+ * The moves (X first, same format as the move scripts) set up the position, without moves the empty board is
+ * analyzed. By default all moves are listed, searched with AiPlayer::kLookAhead.
+ */
+
+#include "AiPlayer.h"
+#include "Board.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/*
+ * scoreText() - explains a score: the side to move wins or loses in a number of moves (plies), or the search
+ * found neither within its look ahead
+ */
+static std::string scoreText(const int score){
+	std::ostringstream text;
+	if (score > 0){
+		text << "win in " << 100 - score;
+	} else if (score < 0){
+		text << "loss in " << 100 + score;
+	} else {
+		text << "draw";
+	}
+	return text.str();
+}
+
+int main(int argc, char* argv[]){
+	int lines = Board::kRows*Board::kCols;
+	int look_ahead = AiPlayer::kLookAhead;
+	long millis = 0;
+	Board board;
+	char mark = 'X';
+
+	for (int i=1; i<argc; i++){
+		std::string option = argv[i];
+		int col = 0;
+		int row = 0;
+		char end = 0;
+		if ((std::sscanf(option.c_str(), "--lines=%d%c", &lines, &end) == 1 && lines > 0)
+				|| (std::sscanf(option.c_str(), "--look-ahead=%d%c", &look_ahead, &end) == 1 && look_ahead > 0)
+				|| (std::sscanf(option.c_str(), "--millis=%ld%c", &millis, &end) == 1 && millis >= 0)){
+			continue;
+		} else if (std::sscanf(option.c_str(), "%d,%d%c", &col, &row, &end) == 2 && board.validMove(row, col)
+				&& board.evaluateBoard() == Board::PLAY){
+			board.makeMove(row, col, mark);
+			mark = (mark == 'X') ? 'O' : 'X';
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [--lines=N] [--look-ahead=N] [--millis=N] [column,row ...]" << std::endl
+					  << "invalid argument or move: " << option << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << Board::kRows << "x" << Board::kCols << " board, " << Board::kWinLine << " in a row, "
+			  << mark << " to move" << std::endl;
+	std::string board_text;
+	board.formatBoard(board_text);
+	std::cout << board_text << std::endl;
+
+	if (board.evaluateBoard() != Board::PLAY){
+		std::cerr << "The game is already over." << std::endl;
+		return 1;
+	}
+
+	AiPlayer player(mark);
+	SearchLimits limits(look_ahead);
+	limits.max_millis = millis;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<PvLine> result = player.analyze(board, limits, lines);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	for (int i=0,max=result.size(); i<max; i++){
+		std::cout << i+1 << ". " << result[i].move.col << "," << result[i].move.row
+				  << "  score " << result[i].move.score << " (" << scoreText(result[i].move.score) << ")  pv:";
+		for (int j=0,moves=result[i].pv.size(); j<moves; j++){
+			std::cout << " " << result[i].pv[j].col << "," << result[i].pv[j].row;
+		}
+		std::cout << std::endl;
+	}
+	std::cout << "(nodes: " << player.getStatistics().nodes << ", time: " << seconds << " s)" << std::endl;
+	return 0;
+}
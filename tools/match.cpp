@@ -0,0 +1,174 @@
+/*
+ * match.cpp
+ *
+ * match - standalone tool playing an engine-vs-engine match between two AiPlayer configurations (MatchRunner).
+ * Game pairs with swapped colors are played on all cores until the SPRT accepts H0 or H1. The engines are
+ * deterministic, so every opening is played by one pair only - the match ends undecided when the openings are used
+ * up. The board size is set at compile time, e.g. for 5x5 with 4 in a row:
+ *
+ *   g++ -O2 -pthread -DTICTACTOE_ROWS=5 -DTICTACTOE_COLS=5 -DTICTACTOE_WIN_LINE=4 -Isrc tools/match.cpp \
+ *       src/MatchRunner.cpp src/AiPlayer.cpp src/SearchContext.cpp src/SearchProfiler.cpp src/PerfCounters.cpp \
+ *       src/PositionCache.cpp src/Game.cpp src/GameSink.cpp src/Player.cpp src/ScriptedPlayer.cpp src/Board.cpp \
+ *       src/TUI.cpp -o match
+ *
+ * Usage: match [options]
+ *   --a-look-ahead=N --b-look-ahead=N		look ahead of engine A / B (default AiPlayer::kLookAhead)
+ *   --a-lmr=0|1 --b-lmr=0|1				late move reductions of engine A / B
+ *   --a-futility=0|1 --b-futility=0|1		futility pruning of engine A / B
+ *   --elo0=E --elo1=E --alpha=P --beta=P	SPRT hypotheses and error rates (default 0, 10, 0.05, 0.05)
+ *   --pairs=N --threads=N					maximum number of game pairs (at most one per opening), number of threads
+ *   										(0 = all cores)
+ *   --openings=FILE						openings in the move script format (moves of both players, X first)
+ *   --plies=N --seed=N						otherwise up to 200 different random openings of N moves (default 2) are
+ *   										generated (small boards have fewer)
+ */
+
+#include "MatchRunner.h"
+#include "ScriptedPlayer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+/*
+ * parseEngineOption() - parses an engine option starting with prefix ("--a-" or "--b-"), returns false if the
+ * option is not one of them
+ */
+static bool parseEngineOption(const std::string& option, const std::string& prefix, EngineConfig& engine){
+	if (option.compare(0, prefix.size(), prefix) != 0){
+		return false;
+	}
+	std::string name = option.substr(prefix.size());
+	int value = 0;
+	char end = 0;
+	if (std::sscanf(name.c_str(), "look-ahead=%d%c", &value, &end) == 1 && value > 0){
+		engine.look_ahead = value;
+	} else if (std::sscanf(name.c_str(), "lmr=%d%c", &value, &end) == 1){
+		engine.options.late_move_reductions = (value != 0);
+	} else if (std::sscanf(name.c_str(), "futility=%d%c", &value, &end) == 1){
+		engine.options.futility_pruning = (value != 0);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/*
+ * printResult() - prints one line with the state of the match
+ */
+static void printResult(const MatchResult& result){
+	std::printf("pairs %5d  A +%d =%d -%d  score %.3f  elo %+7.1f +- %5.1f  LLR %6.3f [%.3f, %.3f]\n",
+			result.pairs, result.wins, result.draws, result.losses, result.score, result.elo, result.elo_error,
+			result.llr, result.llr_lower, result.llr_upper);
+	std::fflush(stdout);
+}
+
+int main(int argc, char* argv[]){
+	EngineConfig engine_a, engine_b;
+	MatchSettings settings;
+	std::string openings_file;
+	int plies = 2;
+	unsigned long seed = 1;
+	const int kRandomOpenings = 200;
+
+	for (int i=1; i<argc; i++){
+		std::string option = argv[i];
+		char end = 0;
+		if (parseEngineOption(option, "--a-", engine_a) || parseEngineOption(option, "--b-", engine_b)){
+			continue;
+		} else if (std::sscanf(option.c_str(), "--elo0=%lf%c", &settings.elo0, &end) == 1
+				|| std::sscanf(option.c_str(), "--elo1=%lf%c", &settings.elo1, &end) == 1
+				|| (std::sscanf(option.c_str(), "--alpha=%lf%c", &settings.alpha, &end) == 1 && settings.alpha > 0 && settings.alpha < 1)
+				|| (std::sscanf(option.c_str(), "--beta=%lf%c", &settings.beta, &end) == 1 && settings.beta > 0 && settings.beta < 1)
+				|| (std::sscanf(option.c_str(), "--pairs=%d%c", &settings.max_pairs, &end) == 1 && settings.max_pairs > 0)
+				|| std::sscanf(option.c_str(), "--threads=%d%c", &settings.threads, &end) == 1
+				|| (std::sscanf(option.c_str(), "--plies=%d%c", &plies, &end) == 1 && plies >= 0)
+				|| std::sscanf(option.c_str(), "--seed=%lu%c", &seed, &end) == 1){
+			continue;
+		} else if (option.compare(0, 11, "--openings=") == 0 && option.size() > 11){
+			openings_file = option.substr(11);
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [--a-look-ahead=N] [--a-lmr=0|1] [--a-futility=0|1] (same for --b-)"
+					  << " [--elo0=E] [--elo1=E] [--alpha=P] [--beta=P] [--pairs=N] [--threads=N]"
+					  << " [--openings=FILE | --plies=N --seed=N]" << std::endl
+					  << "invalid argument: " << option << std::endl;
+			return 1;
+		}
+	}
+	if (settings.elo1 <= settings.elo0){
+		std::cerr << "elo1 has to be larger than elo0" << std::endl;
+		return 1;
+	}
+
+	MatchRunner runner(engine_a, engine_b, settings);
+	std::vector< std::vector<Move> > openings;
+	try {
+		if (!openings_file.empty()){
+			std::ifstream in(openings_file.c_str());
+			if (!in){
+				std::cerr << "cannot open " << openings_file << std::endl;
+				return 1;
+			}
+			MoveScript script;
+			script.read(in, false);
+			for (int i=0; i<script.getGameCount(); i++){
+				openings.push_back(script.getGame(i));
+			}
+		} else {
+			openings = MatchRunner::randomOpenings(kRandomOpenings, plies, seed);
+			if (static_cast<int>(openings.size()) < kRandomOpenings){
+				std::cerr << "warning: only " << openings.size() << " different openings of " << plies
+						  << " moves were found, " << kRandomOpenings << " were requested" << std::endl;
+			}
+		}
+		runner.setOpenings(openings);
+	}
+	catch(const std::invalid_argument& e){
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	if (runner.getOpeningCount() < static_cast<int>(openings.size())){
+		std::cerr << "warning: " << openings.size() - runner.getOpeningCount()
+				  << " openings repeat the position of an earlier one (or a rotated or mirrored copy) and are skipped" << std::endl;
+	}
+	if (runner.getPairLimit() < settings.max_pairs){
+		std::cerr << "warning: the match is limited to " << runner.getPairLimit()
+				  << " pairs, one per different opening (the engines would repeat their games)" << std::endl;
+	}
+
+	std::cout << Board::kRows << "x" << Board::kCols << " board, " << Board::kWinLine << " in a row, "
+			  << runner.getOpeningCount() << " openings" << std::endl
+			  << "A: look ahead " << engine_a.look_ahead << ", lmr " << engine_a.options.late_move_reductions
+			  << ", futility " << engine_a.options.futility_pruning << std::endl
+			  << "B: look ahead " << engine_b.look_ahead << ", lmr " << engine_b.options.late_move_reductions
+			  << ", futility " << engine_b.options.futility_pruning << std::endl
+			  << "SPRT: elo0 " << settings.elo0 << ", elo1 " << settings.elo1 << ", alpha " << settings.alpha
+			  << ", beta " << settings.beta << std::endl;
+
+	int printed = 0;
+	MatchResult result = runner.run([&printed](const MatchResult& progress){
+		if (progress.pairs - printed >= 10 || progress.decision != MatchResult::kUndecided){
+			printResult(progress);
+			printed = progress.pairs;
+		}
+	});
+	if (result.pairs != printed){
+		printResult(result);
+	}
+
+	switch (result.decision){
+	case MatchResult::kAcceptH1:
+		std::cout << "H1 accepted - A is stronger (elo >= " << settings.elo1 << ")" << std::endl;
+		break;
+	case MatchResult::kAcceptH0:
+		std::cout << "H0 accepted - A is not stronger (elo <= " << settings.elo0 << ")" << std::endl;
+		break;
+	default:
+		std::cout << "undecided after " << result.pairs << " pairs" << std::endl;
+		break;
+	}
+	return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * pn_solve.cpp
+ *
+ * pn_solve - standalone tool printing the proven game theoretic value of a tic-tac-toe position (PnSolver).
+ * The board size is set at compile time, e.g. for 4x4 with 4 in a row:
+ *
+ *   g++ -O2 -DTICTACTOE_ROWS=4 -DTICTACTOE_COLS=4 -DTICTACTOE_WIN_LINE=4 -Isrc \
+ *       tools/pn_solve.cpp src/PnSolver.cpp src/Board.cpp src/TUI.cpp -o pn_solve
+ *
+ * Usage: pn_solve [--memory=MB] [--each-move] [column,row ...]
+ * The moves (X first, same format as the move scripts) set up the position to solve, without moves the empty
+ * board is solved. With --each-move every move of the position is solved separately (opening analysis).
+ */
+
+#include "Board.h"
+#include "PnSolver.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/*
+ * resultText() - returns the text of a solver result
+ */
+static const char* resultText(const PnSolver::Result result){
+	switch (result){
+	case PnSolver::kWinX:
+		return "X wins";
+	case PnSolver::kWinO:
+		return "O wins";
+	default:
+		return "draw";
+	}
+}
+
+/*
+ * solveAndPrint() - solves the board and prints the result with the node count and time
+ */
+static void solveAndPrint(PnSolver& solver, Board& board, const char mark, const std::string& label){
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	PnSolver::Result result = solver.solve(board, mark);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << label << ": " << resultText(result)
+			  << "  (nodes: " << solver.getNodes() << ", time: " << seconds << " s"
+			  << ", garbage collections: " << solver.getCollections()
+			  << ", table entries: " << solver.getTableSize() << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]){
+	size_t memory_mb = 1024;
+	bool each_move = false;
+	Board board;
+	char mark = 'X';
+
+	for (int i=1; i<argc; i++){
+		std::string option = argv[i];
+		int col = 0;
+		int row = 0;
+		char end = 0;
+		if (option.compare(0, 9, "--memory=") == 0){
+			memory_mb = std::strtoul(option.c_str() + 9, NULL, 10);
+		} else if (option == "--each-move"){
+			each_move = true;
+		} else if (std::sscanf(option.c_str(), "%d,%d%c", &col, &row, &end) == 2 && board.validMove(row, col)
+				&& board.evaluateBoard() == Board::PLAY){
+			board.makeMove(row, col, mark);
+			mark = (mark == 'X') ? 'O' : 'X';
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [--memory=MB] [--each-move] [column,row ...]" << std::endl
+					  << "invalid argument or move: " << option << std::endl;
+			return 1;
+		}
+	}
+
+	const size_t kEntryBytes = 64;			// approximate size of a transposition table entry incl. hash map overhead
+	PnSolver solver(memory_mb*1024*1024/kEntryBytes);
+
+	std::cout << Board::kRows << "x" << Board::kCols << " board, " << Board::kWinLine << " in a row, "
+			  << mark << " to move" << std::endl;
+	std::string board_text;
+	board.formatBoard(board_text);
+	std::cout << board_text << std::endl;
+
+	if (board.evaluateBoard() != Board::PLAY){
+		std::cerr << "The game is already over." << std::endl;
+		return 1;
+	}
+
+	if (each_move){
+		for (int i=1; i<=Board::kRows; i++){
+			for (int j=1; j<=Board::kCols; j++){
+				if (board.validMove(i,j)){
+					board.makeMove(i, j, mark);
+					solveAndPrint(solver, board, (mark == 'X') ? 'O' : 'X', "move " + std::to_string(j) + "," + std::to_string(i));
+					board.removeMove(i, j);
+				}
+			}
+		}
+	} else {
+		solveAndPrint(solver, board, mark, "position");
+	}
+	return 0;
+}